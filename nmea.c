@@ -21,6 +21,26 @@
 
 #define boolstr(s) ((s) ? "true" : "false")
 
+/**
+ * FNV-1a hash of a sentence body up to the checksum or line ending. Also
+ * yields the body length and its XOR checksum.
+ */
+static uint64_t hash_body(const char *body, size_t *length, uint8_t *checksum)
+{
+    uint64_t hash = UINT64_C(14695981039346656037);
+    uint8_t sum = 0;
+    const char *p = body;
+
+    while (*p && *p != '*' && *p != '\r' && *p != '\n') {
+        hash = (hash ^ (uint8_t) *p) * UINT64_C(1099511628211);
+        sum ^= *p++;
+    }
+
+    *length = p - body;
+    *checksum = sum;
+    return hash;
+}
+
 static int hex2int(char c)
 {
     if (c >= '0' && c <= '9')
@@ -34,8 +54,9 @@ static int hex2int(char c)
 
 uint8_t minmea_checksum(const char *sentence)
 {
-    // Support senteces with or without the starting dollar sign.
-    if (*sentence == '$')
+    // Support senteces with or without the starting dollar sign (or the
+    // exclamation mark of encapsulation sentences).
+    if (*sentence == '$' || *sentence == '!')
         sentence++;
 
     uint8_t checksum = 0x00;
@@ -51,9 +72,10 @@ bool minmea_check(const char *sentence, bool strict)
 {
     uint8_t checksum = 0x00;
 
-    // A valid sentence starts with "$".
-    if (*sentence++ != '$')
+    // A valid sentence starts with "$", or "!" for encapsulation sentences.
+    if (*sentence != '$' && *sentence != '!')
         return false;
+    sentence++;
 
     // The optional checksum is an XOR of all bytes between "$" and "*".
     while (*sentence && *sentence != '*' && isprint((unsigned char) *sentence))
@@ -250,7 +272,7 @@ bool minmea_scan(const char *sentence, const char *format, ...)
                 if (!field)
                     goto parse_error;
 
-                if (field[0] != '$')
+                if (field[0] != '$' && field[0] != '!')
                     goto parse_error;
                 for (int f=0; f<5; f++)
                     if (!minmea_isfield(field[1+f]))
@@ -360,6 +382,13 @@ enum minmea_sentence_id minmea_sentence_id(const char *sentence, bool strict)
     if (!minmea_check(sentence, strict))
         return MINMEA_INVALID;
 
+    // Proprietary sentences don't carry a five-character identifier.
+    if (sentence[1] == 'P') {
+        if (!strncmp(sentence, "$PUBX,00,", 9))
+            return MINMEA_SENTENCE_PUBX_POSITION;
+        return MINMEA_UNKNOWN;
+    }
+
     char type[6];
     if (!minmea_scan(sentence, "t", type))
         return MINMEA_INVALID;
@@ -382,6 +411,10 @@ enum minmea_sentence_id minmea_sentence_id(const char *sentence, bool strict)
         return MINMEA_SENTENCE_VTG;
     if (!strcmp(type+2, "ZDA"))
         return MINMEA_SENTENCE_ZDA;
+    if (!strcmp(type+2, "VDM"))
+        return MINMEA_SENTENCE_VDM;
+    if (!strcmp(type+2, "VDO"))
+        return MINMEA_SENTENCE_VDO;
 
     return MINMEA_UNKNOWN;
 }
@@ -645,6 +678,89 @@ bool minmea_parse_zda(struct minmea_sentence_zda *frame, const char *sentence)
   return true;
 }
 
+bool minmea_parse_vdm(struct minmea_sentence_vdm *frame, const char *sentence)
+{
+    // !AIVDM,2,1,3,B,55P5TL01VIaAL@7WKO@mBplU@<PDhh000000001S;AJ::4A80?4i@E53,0*3E
+    // !AIVDM,1,1,,A,13aEOK?P00PD2wVMdLDRhgvL289?,0*26
+    char type[6];
+    char message_id;
+
+    if (!minmea_scan(sentence, "tiicc_i",
+            type,
+            &frame->fragment_count,
+            &frame->fragment_number,
+            &message_id,
+            &frame->channel,
+            &frame->fill_bits))
+        return false;
+    if (strcmp(type+2, "VDM") && strcmp(type+2, "VDO"))
+        return false;
+
+    if (message_id && !isdigit((unsigned char) message_id))
+        return false;
+    frame->message_id = message_id ? message_id - '0' : -1;
+    frame->own = type[4] == 'O';
+
+    // The payload is referenced in place.
+    const char *payload = sentence;
+    for (int f = 0; f < 5; f++)
+        payload = strchr(payload, ',') + 1;
+    const char *end = payload;
+    while (minmea_isfield(*end))
+        end++;
+    frame->payload = payload;
+    frame->payload_length = end - payload;
+
+    if (frame->fragment_count < 1 || frame->fragment_number < 1 ||
+        frame->fragment_number > frame->fragment_count ||
+        frame->fill_bits < 0 || frame->fill_bits > 5)
+        return false;
+
+    return true;
+}
+
+bool minmea_parse_pubx_position(struct minmea_sentence_pubx_position *frame, const char *sentence)
+{
+    // $PUBX,00,081350.00,4717.113210,N,00833.915187,E,546.589,G3,2.1,2.0,0.007,77.52,0.007,,0.92,1.19,0.77,9,0,0*5F
+    char nav_status[MINMEA_MAX_LONG_SENTENCE_LENGTH];
+    int latitude_direction;
+    int longitude_direction;
+
+    if (strncmp(sentence, "$PUBX,00,", 9))
+        return false;
+    // Bounds the "s" field below.
+    if (strlen(sentence) > MINMEA_MAX_LONG_SENTENCE_LENGTH)
+        return false;
+
+    if (!minmea_scan(sentence, "__Tfdfdfsfffffffffiii",
+            &frame->time,
+            &frame->latitude, &latitude_direction,
+            &frame->longitude, &longitude_direction,
+            &frame->altitude,
+            nav_status,
+            &frame->h_accuracy,
+            &frame->v_accuracy,
+            &frame->speed,
+            &frame->course,
+            &frame->v_velocity,
+            &frame->diff_age,
+            &frame->hdop,
+            &frame->vdop,
+            &frame->tdop,
+            &frame->gps_sats,
+            &frame->glonass_sats,
+            &frame->dead_reckoning))
+        return false;
+
+    frame->nav_status[0] = nav_status[0];
+    frame->nav_status[1] = nav_status[0] ? nav_status[1] : '\0';
+    frame->nav_status[2] = '\0';
+    frame->latitude.value *= latitude_direction;
+    frame->longitude.value *= longitude_direction;
+
+    return true;
+}
+
 int minmea_getdatetime(struct tm *tm, const struct minmea_date *date, const struct minmea_time *time_)
 {
     if (date->year == -1 || time_->hours == -1)
@@ -683,4 +799,735 @@ int minmea_gettime(struct timespec *ts, const struct minmea_date *date, const st
     }
 }
 
+int_least32_t minmea_daynumber(const struct minmea_date *date)
+{
+    if (date->year == -1)
+        return -1;
+
+    int_least32_t y = date->year;
+    if (y < 80)
+        y += 2000;
+    else if (y < 1900)
+        y += 1900;
+
+    // Days from civil, with the year starting in March.
+    int_least32_t m = date->month;
+    if (m <= 2)
+        y--;
+    int_least32_t era = (y >= 0 ? y : y - 399) / 400;
+    int_least32_t yoe = y - era * 400;
+    int_least32_t doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + date->day - 1;
+    int_least32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+
+    return era * 146097 + doe - 719468;
+}
+
+bool minmea_sentence_time(struct minmea_date *date, struct minmea_time *time_, const char *sentence)
+{
+    char type[6];
+    bool result;
+
+    date->day = date->month = date->year = -1;
+
+    if (!strncmp(sentence, "$PUBX,00,", 9))
+        return minmea_scan(sentence, "__T", time_) && time_->hours != -1;
+    if (!minmea_scan(sentence, "t", type))
+        return false;
+
+    if (!strcmp(type+2, "GGA") || !strcmp(type+2, "GBS") || !strcmp(type+2, "GST")) {
+        result = minmea_scan(sentence, "tT", type, time_);
+    } else if (!strcmp(type+2, "RMC")) {
+        result = minmea_scan(sentence, "tT_______D", type, time_, date);
+    } else if (!strcmp(type+2, "GLL")) {
+        result = minmea_scan(sentence, "t____T", type, time_);
+    } else if (!strcmp(type+2, "ZDA")) {
+        result = minmea_scan(sentence, "tTiii", type, time_, &date->day, &date->month, &date->year);
+        // Empty ZDA date fields scan as zero.
+        if (date->day == 0)
+            date->day = date->month = date->year = -1;
+    } else {
+        return false;
+    }
+
+    return result && time_->hours != -1;
+}
+
+uint32_t minmea_pack_time(const struct minmea_time *time_)
+{
+    int_least64_t us = minmea_time_us(time_);
+    if (us < 0)
+        return MINMEA_PACKED_UNKNOWN_TIME;
+    return (uint32_t) (us / 1000);
+}
+
+void minmea_unpack_time(struct minmea_time *time_, uint32_t time_ms)
+{
+    if (time_ms == MINMEA_PACKED_UNKNOWN_TIME) {
+        time_->hours = time_->minutes = time_->seconds = time_->microseconds = -1;
+        return;
+    }
+    time_->hours = time_ms / 3600000;
+    time_->minutes = time_ms / 60000 % 60;
+    time_->seconds = time_ms / 1000 % 60;
+    time_->microseconds = time_ms % 1000 * 1000;
+}
+
+uint16_t minmea_pack_date(const struct minmea_date *date)
+{
+    int_least32_t day = minmea_daynumber(date);
+    if (day < 0 || day >= MINMEA_PACKED_UNKNOWN_U16)
+        return MINMEA_PACKED_UNKNOWN_U16;
+    return (uint16_t) day;
+}
+
+void minmea_unpack_date(struct minmea_date *date, uint16_t day)
+{
+    if (day == MINMEA_PACKED_UNKNOWN_U16) {
+        date->day = date->month = date->year = -1;
+        return;
+    }
+
+    // Civil from days, with the year starting in March.
+    int_least32_t z = day + 719468;
+    int_least32_t era = z / 146097;
+    int_least32_t doe = z - era * 146097;
+    int_least32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    int_least32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    int_least32_t mp = (5 * doy + 2) / 153;
+    int_least32_t m = mp < 10 ? mp + 3 : mp - 9;
+
+    date->day = doy - (153 * mp + 2) / 5 + 1;
+    date->month = m;
+    date->year = yoe + era * 400 + (m <= 2);
+}
+
+int32_t minmea_pack_coord(const struct minmea_float *f)
+{
+    double degrees = minmea_tocoord_double(f);
+    if (isnan(degrees))
+        return MINMEA_PACKED_UNKNOWN;
+
+    // 1e-7 degrees, rounded to nearest.
+    return (int32_t) lround(degrees * 1e7);
+}
+
+void minmea_unpack_coord(struct minmea_float *f, int32_t coord)
+{
+    if (coord == MINMEA_PACKED_UNKNOWN) {
+        *f = (struct minmea_float) {0, 0};
+        return;
+    }
+
+    // Back to ddmm.mmmmm.
+    int_least64_t degrees = coord / 10000000;
+    int_least64_t frac = coord % 10000000;
+    int_least64_t minutes = (frac * 60 * 100000 + (frac >= 0 ? 5000000 : -5000000)) / 10000000;
+    *f = (struct minmea_float) {(int_least32_t) (degrees * 100 * 100000 + minutes), 100000};
+}
+
+int32_t minmea_pack_float(const struct minmea_float *f, int32_t scale)
+{
+    if (f->scale == 0)
+        return MINMEA_PACKED_UNKNOWN;
+    return minmea_rescale(f, scale);
+}
+
+void minmea_unpack_float(struct minmea_float *f, int32_t value, int32_t scale)
+{
+    if (value == MINMEA_PACKED_UNKNOWN)
+        *f = (struct minmea_float) {0, 0};
+    else
+        *f = (struct minmea_float) {value, scale};
+}
+
+static uint16_t pack_u16(const struct minmea_float *f, int32_t scale)
+{
+    int32_t value = minmea_pack_float(f, scale);
+    if (value == MINMEA_PACKED_UNKNOWN || value < 0 || value >= MINMEA_PACKED_UNKNOWN_U16)
+        return MINMEA_PACKED_UNKNOWN_U16;
+    return (uint16_t) value;
+}
+
+static void unpack_u16(struct minmea_float *f, uint16_t value, int32_t scale)
+{
+    minmea_unpack_float(f, value == MINMEA_PACKED_UNKNOWN_U16 ? MINMEA_PACKED_UNKNOWN : value, scale);
+}
+
+static int16_t pack_s16(const struct minmea_float *f, int32_t scale)
+{
+    int32_t value = minmea_pack_float(f, scale);
+    if (value == MINMEA_PACKED_UNKNOWN || value <= MINMEA_PACKED_UNKNOWN_S16 || value > INT16_MAX)
+        return MINMEA_PACKED_UNKNOWN_S16;
+    return (int16_t) value;
+}
+
+static void unpack_s16(struct minmea_float *f, int16_t value, int32_t scale)
+{
+    minmea_unpack_float(f, value == MINMEA_PACKED_UNKNOWN_S16 ? MINMEA_PACKED_UNKNOWN : value, scale);
+}
+
+static uint8_t pack_u8(int value)
+{
+    return value < 0 ? 0 : value > UINT8_MAX ? UINT8_MAX : value;
+}
+
+void minmea_pack_gga(struct minmea_packed_gga *packed, const struct minmea_sentence_gga *frame)
+{
+    packed->time_ms = minmea_pack_time(&frame->time);
+    packed->latitude = minmea_pack_coord(&frame->latitude);
+    packed->longitude = minmea_pack_coord(&frame->longitude);
+    packed->altitude = minmea_pack_float(&frame->altitude, 1000);
+    packed->height = pack_s16(&frame->height, 100);
+    packed->hdop = pack_u16(&frame->hdop, 100);
+    packed->dgps_age = pack_u16(&frame->dgps_age, 10);
+    packed->fix_quality = pack_u8(frame->fix_quality);
+    packed->satellites_tracked = pack_u8(frame->satellites_tracked);
+}
+
+void minmea_unpack_gga(struct minmea_sentence_gga *frame, const struct minmea_packed_gga *packed)
+{
+    minmea_unpack_time(&frame->time, packed->time_ms);
+    minmea_unpack_coord(&frame->latitude, packed->latitude);
+    minmea_unpack_coord(&frame->longitude, packed->longitude);
+    minmea_unpack_float(&frame->altitude, packed->altitude, 1000);
+    unpack_s16(&frame->height, packed->height, 100);
+    unpack_u16(&frame->hdop, packed->hdop, 100);
+    unpack_u16(&frame->dgps_age, packed->dgps_age, 10);
+    frame->fix_quality = packed->fix_quality;
+    frame->satellites_tracked = packed->satellites_tracked;
+    frame->altitude_units = frame->altitude.scale ? 'M' : '\0';
+    frame->height_units = frame->height.scale ? 'M' : '\0';
+}
+
+void minmea_pack_rmc(struct minmea_packed_rmc *packed, const struct minmea_sentence_rmc *frame)
+{
+    packed->time_ms = minmea_pack_time(&frame->time);
+    packed->latitude = minmea_pack_coord(&frame->latitude);
+    packed->longitude = minmea_pack_coord(&frame->longitude);
+    packed->day = minmea_pack_date(&frame->date);
+    packed->speed = pack_u16(&frame->speed, 100);
+    packed->course = pack_u16(&frame->course, 100);
+    packed->variation = pack_s16(&frame->variation, 100);
+    packed->valid = frame->valid;
+}
+
+void minmea_unpack_rmc(struct minmea_sentence_rmc *frame, const struct minmea_packed_rmc *packed)
+{
+    minmea_unpack_time(&frame->time, packed->time_ms);
+    minmea_unpack_coord(&frame->latitude, packed->latitude);
+    minmea_unpack_coord(&frame->longitude, packed->longitude);
+    minmea_unpack_date(&frame->date, packed->day);
+    unpack_u16(&frame->speed, packed->speed, 100);
+    unpack_u16(&frame->course, packed->course, 100);
+    unpack_s16(&frame->variation, packed->variation, 100);
+    frame->valid = packed->valid;
+}
+
+bool minmea_parse_gga_packed(struct minmea_packed_gga *packed, const char *sentence)
+{
+    struct minmea_sentence_gga frame;
+    if (!minmea_parse_gga(&frame, sentence))
+        return false;
+    minmea_pack_gga(packed, &frame);
+    return true;
+}
+
+bool minmea_parse_rmc_packed(struct minmea_packed_rmc *packed, const char *sentence)
+{
+    struct minmea_sentence_rmc frame;
+    if (!minmea_parse_rmc(&frame, sentence))
+        return false;
+    minmea_pack_rmc(packed, &frame);
+    return true;
+}
+
+void minmea_long_pool_init(struct minmea_long_pool *pool)
+{
+    pool->free_mask = (MINMEA_LONG_POOL_SLOTS >= 32) ? UINT32_MAX : ((UINT32_C(1) << MINMEA_LONG_POOL_SLOTS) - 1);
+}
+
+int minmea_long_pool_alloc(struct minmea_long_pool *pool)
+{
+    if (!pool->free_mask)
+        return -1;
+
+    int slot = 0;
+    while (!(pool->free_mask & (UINT32_C(1) << slot)))
+        slot++;
+    pool->free_mask &= ~(UINT32_C(1) << slot);
+
+    return slot;
+}
+
+void minmea_long_pool_free(struct minmea_long_pool *pool, int slot)
+{
+    if (slot >= 0 && slot < MINMEA_LONG_POOL_SLOTS)
+        pool->free_mask |= UINT32_C(1) << slot;
+}
+
+static void minmea_framer_release(struct minmea_framer *framer)
+{
+    if (framer->slot >= 0)
+        minmea_long_pool_free(framer->pool, framer->slot);
+    framer->slot = -1;
+    framer->line = framer->buf;
+    framer->capacity = MINMEA_MAX_SENTENCE_LENGTH;
+}
+
+void minmea_framer_init(struct minmea_framer *framer, struct minmea_long_pool *pool)
+{
+    framer->pool = pool;
+    framer->slot = -1;
+    framer->overflows = 0;
+    framer->binary = NULL;
+    framer->binary_user = NULL;
+    framer->binary_frames = 0;
+    framer->binary_errors = 0;
+    framer->resyncs = 0;
+    minmea_framer_reset(framer);
+}
+
+void minmea_framer_reset(struct minmea_framer *framer)
+{
+    minmea_framer_release(framer);
+    framer->length = 0;
+    framer->active = false;
+    framer->discard = false;
+    framer->protocol = MINMEA_BINARY_NONE;
+}
+
+void minmea_framer_set_binary(struct minmea_framer *framer, minmea_binary_cb callback, void *user)
+{
+    framer->binary = callback;
+    framer->binary_user = user;
+}
+
+static bool framer_valid(const struct minmea_framer *framer)
+{
+    if (framer->protocol == MINMEA_BINARY_UBX)
+        return (framer->check & 0xff) == framer->trailer[0] &&
+               (framer->check >> 8) == framer->trailer[1];
+    return framer->check == ((uint32_t) framer->trailer[0] << 16 |
+                             (uint32_t) framer->trailer[1] << 8 |
+                             framer->trailer[2]);
+}
+
+static void framer_deliver(struct minmea_framer *framer, const uint8_t *data, size_t length, bool last, bool valid)
+{
+    struct minmea_binary_fragment fragment = {
+        .protocol = framer->protocol,
+        .data = data,
+        .length = length,
+        .offset = framer->frame_offset,
+        .total = framer->frame_length,
+        .last = last,
+        .valid = last && valid,
+    };
+
+    framer->binary(&fragment, framer->binary_user);
+}
+
+/**
+ * Update the running UBX Fletcher-8 or RTCM3 CRC-24Q checksum with the byte
+ * at the given frame offset, or stash it if it belongs to the trailer.
+ */
+static void framer_check(struct minmea_framer *framer, size_t offset, uint8_t byte)
+{
+    if (framer->protocol == MINMEA_BINARY_UBX) {
+        // Covers class, id, length and payload.
+        if (offset >= framer->frame_length - 2) {
+            framer->trailer[offset - (framer->frame_length - 2)] = byte;
+        } else if (offset >= 2) {
+            uint32_t ck_a = (framer->check + byte) & 0xff;
+            uint32_t ck_b = ((framer->check >> 8) + ck_a) & 0xff;
+            framer->check = ck_b << 8 | ck_a;
+        }
+    } else {
+        // Covers header and payload.
+        if (offset >= framer->frame_length - 3) {
+            framer->trailer[offset - (framer->frame_length - 3)] = byte;
+        } else {
+            framer->check ^= (uint32_t) byte << 16;
+            for (int bit = 0; bit < 8; bit++) {
+                framer->check <<= 1;
+                if (framer->check & 0x1000000)
+                    framer->check ^= 0x1864cfb;
+            }
+        }
+    }
+}
+
+/**
+ * Consume bytes of the binary frame being skipped. Returns the number of
+ * bytes used; on a header that turns out not to be a frame, the offending
+ * byte is left unconsumed for resynchronization, and on a frame that fails
+ * its checksum, everything passed in this call is.
+ */
+static size_t framer_binary(struct minmea_framer *framer, const uint8_t *data, size_t length)
+{
+    size_t used = 0;
+    size_t header_size = framer->protocol == MINMEA_BINARY_UBX ? 6 : 3;
+
+    while (framer->header_length < header_size) {
+        if (used == length)
+            return used;
+
+        uint8_t byte = data[used];
+        if (framer->header_length == 1) {
+            // UBX sync char 2, or the RTCM3 reserved bits.
+            bool ok = framer->protocol == MINMEA_BINARY_UBX ? byte == 0x62 : (byte & 0xfc) == 0;
+            if (!ok) {
+                framer->protocol = MINMEA_BINARY_NONE;
+                framer->resyncs++;
+                return used;
+            }
+        }
+        framer->header[framer->header_length++] = byte;
+        used++;
+    }
+
+    if (framer->frame_length == 0) {
+        size_t payload;
+        if (framer->protocol == MINMEA_BINARY_UBX) {
+            payload = framer->header[4] | framer->header[5] << 8;
+            if (payload > MINMEA_UBX_MAX_PAYLOAD) {
+                framer->protocol = MINMEA_BINARY_NONE;
+                framer->resyncs++;
+                return used;
+            }
+            framer->frame_length = header_size + payload + 2;
+        } else {
+            payload = (framer->header[1] & 0x03) << 8 | framer->header[2];
+            framer->frame_length = header_size + payload + 3;
+        }
+
+        framer->check = 0;
+        framer->frame_offset = 0;
+        for (size_t k = 0; k < header_size; k++)
+            framer_check(framer, k, framer->header[k]);
+        if (framer->binary)
+            framer_deliver(framer, framer->header, header_size, false, false);
+        framer->frame_offset = header_size;
+    }
+
+    size_t take = framer->frame_length - framer->frame_offset;
+    if (take > length - used)
+        take = length - used;
+
+    for (size_t k = 0; k < take; k++)
+        framer_check(framer, framer->frame_offset + k, data[used + k]);
+    bool last = framer->frame_offset + take == framer->frame_length;
+    bool valid = last && framer_valid(framer);
+    if (framer->binary)
+        framer_deliver(framer, data + used, take, last, valid);
+
+    framer->frame_offset += take;
+    used += take;
+
+    if (last) {
+        framer->protocol = MINMEA_BINARY_NONE;
+        if (!valid) {
+            // Most likely noise that looked like a header (an RTCM3 one is
+            // only 8 bits of sync and 6 of zeros). Look for sentences again
+            // in what this call passed in; earlier calls' bytes are gone.
+            framer->binary_errors++;
+            framer->resyncs++;
+            return 0;
+        }
+        framer->binary_frames++;
+    }
+
+    return used;
+}
+
+/**
+ * Offset of the first byte that can start a sentence or binary frame, or
+ * length if there is none.
+ */
+static size_t framer_scan(const char *data, size_t length)
+{
+    static const char starts[] = { '$', '!', (char) 0xb5, (char) 0xd3 };
+    size_t end = length;
+
+    // Each search only has to cover the input before the nearest start so far.
+    for (size_t k = 0; k < sizeof(starts) && end > 0; k++) {
+        const char *p = memchr(data, starts[k], end);
+        if (p)
+            end = p - data;
+    }
+
+    return end;
+}
+
+size_t minmea_framer_push(struct minmea_framer *framer, const char *data, size_t length, const char **sentence)
+{
+    size_t i = 0;
+
+    *sentence = NULL;
+
+    // The previous sentence has been consumed; give its long slot back.
+    if (!framer->active && framer->slot >= 0)
+        minmea_framer_release(framer);
+
+    while (i < length) {
+        if (framer->protocol != MINMEA_BINARY_NONE) {
+            i += framer_binary(framer, (const uint8_t *) data + i, length - i);
+            continue;
+        }
+
+        if (!framer->active) {
+            unsigned char c = data[i];
+
+            if (c == '\r' || c == '\n') {
+                i++;
+                continue;
+            }
+
+            if (c == 0xb5 || c == 0xd3) {
+                framer->protocol = c == 0xb5 ? MINMEA_BINARY_UBX : MINMEA_BINARY_RTCM3;
+                framer->header[0] = c;
+                framer->header_length = 1;
+                framer->frame_length = 0;
+                i++;
+                continue;
+            }
+
+            if (c != '$' && c != '!') {
+                // Noise; skip to the next sentence or binary frame start.
+                framer->resyncs++;
+                i++;
+                i += framer_scan(data + i, length - i);
+                continue;
+            }
+
+            framer->active = true;
+            framer->discard = false;
+            framer->length = 0;
+        }
+
+        char c = data[i];
+
+        if (c == '\r' || c == '\n') {
+            i++;
+            framer->active = false;
+            if (framer->discard)
+                continue;
+            framer->line[framer->length] = '\0';
+            *sentence = framer->line;
+            return i;
+        }
+
+        if (!isprint((unsigned char) c)) {
+            // A binary frame or noise cut the sentence short. Drop it and
+            // look at this byte again outside of a sentence.
+            framer->active = false;
+            framer->resyncs++;
+            continue;
+        }
+
+        i++;
+
+        if (c == '$' || c == '!') {
+            // Truncated sentence; start over.
+            framer->discard = false;
+            framer->length = 0;
+        }
+
+        if (framer->discard)
+            continue;
+
+        if (framer->length == framer->capacity) {
+            int slot = -1;
+            if (framer->slot < 0 && framer->pool)
+                slot = minmea_long_pool_alloc(framer->pool);
+            if (slot < 0) {
+                framer->discard = true;
+                framer->overflows++;
+                continue;
+            }
+            memcpy(framer->pool->slots[slot], framer->buf, framer->length);
+            framer->slot = slot;
+            framer->line = framer->pool->slots[slot];
+            framer->capacity = MINMEA_MAX_LONG_SENTENCE_LENGTH;
+        }
+
+        framer->line[framer->length++] = c;
+    }
+
+    return i;
+}
+
+static uint8_t dedup_rank(const struct minmea_dedup *dedup, const char *talker)
+{
+    for (size_t i = 0; dedup->prefer[i] && dedup->prefer[i+1]; i += 2)
+        if (dedup->prefer[i] == talker[0] && dedup->prefer[i+1] == talker[1])
+            return i / 2;
+    return UINT8_MAX;
+}
+
+void minmea_dedup_init(struct minmea_dedup *dedup, const char *prefer, uint32_t max_age)
+{
+    memset(dedup, 0, sizeof(*dedup));
+    dedup->max_age = max_age;
+    if (prefer)
+        strncpy(dedup->prefer, prefer, sizeof(dedup->prefer) - 1);
+}
+
+static bool dedup_shadowed(const struct minmea_dedup_type *type, const char *talker)
+{
+    for (size_t i = 0; i < 4; i++)
+        if (type->shadowed[i][0] == talker[0] && type->shadowed[i][1] == talker[1])
+            return true;
+    return false;
+}
+
+bool minmea_dedup_accept(struct minmea_dedup *dedup, const char *sentence)
+{
+    const char *talker = sentence + 1;
+    const char *body = talker;
+    uint8_t rank = UINT8_MAX;
+    struct minmea_dedup_type *type = NULL;
+
+    uint32_t now = ++dedup->clock;
+
+    // Key standard sentences on the content after the talker identifier.
+    if (body[0] && body[0] != 'P' && body[1]) {
+        rank = dedup_rank(dedup, talker);
+        body += 2;
+
+        uint32_t key = 0;
+        for (int i = 0; i < 3 && body[i] && body[i] != ','; i++)
+            key = key << 8 | (uint8_t) body[i];
+        type = &dedup->types[(key ^ key >> 11) & (MINMEA_DEDUP_TYPES - 1)];
+        if (type->stamp == 0 || type->type != key ||
+                (dedup->max_age != 0 && now - type->stamp > dedup->max_age)) {
+            // Not seen repeated yet, or its preferred talker went quiet.
+            memset(type, 0, sizeof(*type));
+            type->type = key;
+            type->rank = UINT8_MAX;
+        } else if (rank > type->rank && dedup_shadowed(type, talker)) {
+            dedup->dropped++;
+            return false;
+        } else if (rank == type->rank) {
+            type->stamp = now;
+        }
+    }
+
+    size_t length;
+    uint8_t checksum;
+    uint64_t wide = hash_body(body, &length, &checksum);
+    uint32_t hash = (uint32_t) (wide ^ (wide >> 32));
+
+    struct minmea_dedup_entry *entry = &dedup->entries[hash & (MINMEA_DEDUP_SIZE - 1)];
+
+    bool hit = entry->stamp != 0 &&
+        entry->hash == hash &&
+        entry->length == length &&
+        entry->checksum == checksum &&
+        (dedup->max_age == 0 || now - entry->stamp <= dedup->max_age);
+
+    if (hit) {
+        // The copy already passed stands; later epochs go to the preferred
+        // talker only.
+        if (type && rank != entry->rank) {
+            const char *loser = rank < entry->rank ? entry->talker : talker;
+            uint8_t winner = rank < entry->rank ? rank : entry->rank;
+            if (winner < type->rank)
+                type->rank = winner;
+            if (!dedup_shadowed(type, loser)) {
+                memmove(type->shadowed[1], type->shadowed[0], 3 * sizeof(type->shadowed[0]));
+                memcpy(type->shadowed[0], loser, 2);
+            }
+            type->stamp = now;
+        }
+        dedup->dropped++;
+        return false;
+    }
+
+    entry->hash = hash;
+    entry->length = length;
+    entry->checksum = checksum;
+    entry->rank = rank;
+    memcpy(entry->talker, talker, 2);
+    entry->stamp = now;
+    dedup->passed++;
+
+    return true;
+}
+
+enum minmea_sentence_id minmea_parse(union minmea_frame *frame, const char *sentence, bool strict)
+{
+    enum minmea_sentence_id id = minmea_sentence_id(sentence, strict);
+    bool ok;
+
+    switch (id) {
+        case MINMEA_SENTENCE_GBS: ok = minmea_parse_gbs(&frame->gbs, sentence); break;
+        case MINMEA_SENTENCE_GGA: ok = minmea_parse_gga(&frame->gga, sentence); break;
+        case MINMEA_SENTENCE_GLL: ok = minmea_parse_gll(&frame->gll, sentence); break;
+        case MINMEA_SENTENCE_GSA: ok = minmea_parse_gsa(&frame->gsa, sentence); break;
+        case MINMEA_SENTENCE_GST: ok = minmea_parse_gst(&frame->gst, sentence); break;
+        case MINMEA_SENTENCE_GSV: ok = minmea_parse_gsv(&frame->gsv, sentence); break;
+        case MINMEA_SENTENCE_RMC: ok = minmea_parse_rmc(&frame->rmc, sentence); break;
+        case MINMEA_SENTENCE_VTG: ok = minmea_parse_vtg(&frame->vtg, sentence); break;
+        case MINMEA_SENTENCE_ZDA: ok = minmea_parse_zda(&frame->zda, sentence); break;
+        case MINMEA_SENTENCE_PUBX_POSITION: ok = minmea_parse_pubx_position(&frame->pubx_position, sentence); break;
+        // No frame member: AIS payloads point into the sentence (see minmea_parse_vdm()).
+        default: return id == MINMEA_INVALID ? MINMEA_INVALID : MINMEA_UNKNOWN;
+    }
+
+    return ok ? id : MINMEA_INVALID;
+}
+
+bool minmea_parse_cache_init(struct minmea_parse_cache *cache, struct minmea_parse_cache_entry *entries, size_t count)
+{
+    if (count == 0 || (count & (count - 1)) != 0)
+        return false;
+
+    memset(entries, 0, count * sizeof(*entries));
+    for (size_t i = 0; i < count; i++)
+        entries[i].id = MINMEA_INVALID;
+    cache->entries = entries;
+    cache->mask = count - 1;
+    cache->hits = 0;
+    cache->misses = 0;
+    return true;
+}
+
+enum minmea_sentence_id minmea_parse_cached(struct minmea_parse_cache *cache, union minmea_frame *frame, const char *sentence, bool strict)
+{
+    size_t length;
+    uint8_t checksum;
+    uint64_t hash = hash_body(sentence, &length, &checksum);
+    bool checksummed = sentence[length] == '*';
+
+    // Include the transmitted checksum and whatever follows it, so only
+    // byte-identical input hits: minmea_parse() rejects trailing garbage.
+    for (const char *p = sentence + length; *p; p++, length++)
+        hash = (hash ^ (uint8_t) *p) * UINT64_C(1099511628211);
+
+    struct minmea_parse_cache_entry *entry = &cache->entries[(hash ^ (hash >> 32)) & cache->mask];
+
+    if (entry->id != MINMEA_INVALID &&
+        (checksummed || !strict) &&
+        entry->hash == hash &&
+        entry->length == length &&
+        entry->checksum == checksum) {
+        cache->hits++;
+        *frame = entry->frame;
+        return entry->id;
+    }
+
+    cache->misses++;
+    enum minmea_sentence_id id = minmea_parse(frame, sentence, strict);
+    if (id > MINMEA_UNKNOWN && length <= UINT16_MAX) {
+        entry->hash = hash;
+        entry->length = length;
+        entry->checksum = checksum;
+        entry->id = id;
+        entry->frame = *frame;
+    }
+
+    return id;
+}
+
 /* vim: set ts=4 sw=4 et: */
\ No newline at end of file
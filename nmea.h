@@ -34,6 +34,33 @@ extern "C" {
 #define MINMEA_MAX_SENTENCE_LENGTH 80
 #endif
 
+// Upper bound for proprietary sentences ($PUBX, $PSSN, ...) that exceed the
+// standard NMEA length. Only the shared long sentence pool is sized by this.
+#ifndef MINMEA_MAX_LONG_SENTENCE_LENGTH
+#define MINMEA_MAX_LONG_SENTENCE_LENGTH 256
+#endif
+
+// Number of long sentence slots in a struct minmea_long_pool (at most 32).
+#ifndef MINMEA_LONG_POOL_SLOTS
+#define MINMEA_LONG_POOL_SLOTS 8
+#endif
+
+// Largest UBX payload the framer accepts as a frame rather than noise.
+#ifndef MINMEA_UBX_MAX_PAYLOAD
+#define MINMEA_UBX_MAX_PAYLOAD 8192
+#endif
+
+// Number of entries in a struct minmea_dedup (power of two).
+#ifndef MINMEA_DEDUP_SIZE
+#define MINMEA_DEDUP_SIZE 64
+#endif
+
+// Sentence types whose preferred talker a struct minmea_dedup remembers
+// (power of two).
+#ifndef MINMEA_DEDUP_TYPES
+#define MINMEA_DEDUP_TYPES 16
+#endif
+
 enum minmea_sentence_id {
     MINMEA_INVALID = -1,
     MINMEA_UNKNOWN = 0,
@@ -46,6 +73,9 @@ enum minmea_sentence_id {
     MINMEA_SENTENCE_RMC,
     MINMEA_SENTENCE_VTG,
     MINMEA_SENTENCE_ZDA,
+    MINMEA_SENTENCE_PUBX_POSITION,
+    MINMEA_SENTENCE_VDM,
+    MINMEA_SENTENCE_VDO,
 };
 
 struct minmea_float {
@@ -184,6 +214,216 @@ struct minmea_sentence_zda {
     int minute_offset;
 };
 
+// AIS encapsulation sentence (!AIVDM / !AIVDO). The armored payload points
+// into the parsed sentence and is not NUL-terminated.
+struct minmea_sentence_vdm {
+    int fragment_count;
+    int fragment_number;
+    int message_id;
+    char channel;
+    const char *payload;
+    int payload_length;
+    int fill_bits;
+    bool own;
+};
+
+// u-blox proprietary position sentence ($PUBX,00).
+struct minmea_sentence_pubx_position {
+    struct minmea_time time;
+    struct minmea_float latitude;
+    struct minmea_float longitude;
+    struct minmea_float altitude;
+    char nav_status[3];
+    struct minmea_float h_accuracy;
+    struct minmea_float v_accuracy;
+    struct minmea_float speed;
+    struct minmea_float course;
+    struct minmea_float v_velocity;
+    struct minmea_float diff_age;
+    struct minmea_float hdop;
+    struct minmea_float vdop;
+    struct minmea_float tdop;
+    int gps_sats;
+    int glonass_sats;
+    int dead_reckoning;
+};
+
+/**
+ * Shared overflow storage for sentences longer than MINMEA_MAX_SENTENCE_LENGTH.
+ * A bit set in free_mask marks a free slot.
+ */
+struct minmea_long_pool {
+    uint32_t free_mask;
+    char slots[MINMEA_LONG_POOL_SLOTS][MINMEA_MAX_LONG_SENTENCE_LENGTH + 1];
+};
+
+enum minmea_binary_protocol {
+    MINMEA_BINARY_NONE = 0,
+    MINMEA_BINARY_UBX,
+    MINMEA_BINARY_RTCM3,
+};
+
+/**
+ * Part of a binary frame found between sentences. A frame split across
+ * minmea_framer_push() calls is delivered in several fragments; valid
+ * reports the frame checksum on the last one.
+ */
+struct minmea_binary_fragment {
+    enum minmea_binary_protocol protocol;
+    const uint8_t *data;
+    size_t length;
+    size_t offset;
+    size_t total;
+    bool last;
+    bool valid;
+};
+
+typedef void (*minmea_binary_cb)(const struct minmea_binary_fragment *fragment, void *user);
+
+/**
+ * Incremental sentence framer. Standard sentences are assembled in the inline
+ * buffer; a sentence outgrowing it moves to a slot borrowed from the (optional)
+ * long sentence pool for as long as it is being assembled.
+ * UBX and RTCM3 frames between sentences are recognized by their headers and
+ * skipped by length once their checksum verifies; anything else resynchronizes
+ * on the next "$", "!" or binary frame header. A frame failing its checksum is
+ * taken as noise: the bytes of it passed to the same minmea_framer_push() call
+ * are searched for sentences again.
+ */
+struct minmea_framer {
+    struct minmea_long_pool *pool;
+    char *line;
+    size_t length;
+    size_t capacity;
+    int slot;
+    bool active;
+    bool discard;
+    unsigned long overflows;
+    char buf[MINMEA_MAX_SENTENCE_LENGTH + 1];
+
+    // Interleaved UBX/RTCM3 frames.
+    minmea_binary_cb binary;
+    void *binary_user;
+    enum minmea_binary_protocol protocol;
+    size_t header_length;
+    size_t frame_offset;
+    size_t frame_length;
+    uint32_t check;
+    uint8_t header[6];
+    uint8_t trailer[3];
+    unsigned long binary_frames;
+    unsigned long binary_errors;
+    unsigned long resyncs;
+};
+
+struct minmea_dedup_entry {
+    uint32_t hash;
+    uint32_t stamp;
+    uint16_t length;
+    uint8_t checksum;
+    uint8_t rank;
+    char talker[2];
+};
+
+// Talkers seen repeating the copies of a more preferred talker for a type.
+struct minmea_dedup_type {
+    uint32_t type;
+    uint32_t stamp;
+    char shadowed[4][2];
+    uint8_t rank;
+};
+
+/**
+ * Direct-mapped cache of recently seen sentence contents. Entries are keyed
+ * on the sentence body after the talker identifier, so the same content sent
+ * as GPGGA and GNGGA is recognized as a duplicate.
+ */
+struct minmea_dedup {
+    struct minmea_dedup_entry entries[MINMEA_DEDUP_SIZE];
+    struct minmea_dedup_type types[MINMEA_DEDUP_TYPES];
+    uint32_t clock;
+    uint32_t max_age;
+    char prefer[16];
+    unsigned long passed;
+    unsigned long dropped;
+};
+
+// Markers for unknown values in packed frames.
+#define MINMEA_PACKED_UNKNOWN       INT32_MIN
+#define MINMEA_PACKED_UNKNOWN_U16   UINT16_MAX
+#define MINMEA_PACKED_UNKNOWN_S16   INT16_MIN
+#define MINMEA_PACKED_UNKNOWN_TIME  UINT32_MAX
+
+/**
+ * Compact GGA fix (24 bytes). Time in milliseconds since midnight,
+ * coordinates in 1e-7 degrees, altitude in millimeters, height (geoid
+ * separation, within +-110 m) in centimeters, hdop in hundredths and
+ * dgps_age in tenths of a second. Both units are meters, the only unit GGA
+ * uses, and are not stored.
+ */
+struct minmea_packed_gga {
+    uint32_t time_ms;
+    int32_t latitude;
+    int32_t longitude;
+    int32_t altitude;
+    int16_t height;
+    uint16_t hdop;
+    uint16_t dgps_age;
+    uint8_t fix_quality;
+    uint8_t satellites_tracked;
+};
+
+/**
+ * Compact RMC fix (24 bytes). Date as days since 1970-01-01, speed in
+ * hundredths of a knot, course and variation in hundredths of a degree.
+ */
+struct minmea_packed_rmc {
+    uint32_t time_ms;
+    int32_t latitude;
+    int32_t longitude;
+    uint16_t day;
+    uint16_t speed;
+    uint16_t course;
+    int16_t variation;
+    bool valid;
+};
+
+/**
+ * Storage for any parsed sentence.
+ */
+union minmea_frame {
+    struct minmea_sentence_gbs gbs;
+    struct minmea_sentence_rmc rmc;
+    struct minmea_sentence_gga gga;
+    struct minmea_sentence_gsa gsa;
+    struct minmea_sentence_gll gll;
+    struct minmea_sentence_gst gst;
+    struct minmea_sentence_gsv gsv;
+    struct minmea_sentence_vtg vtg;
+    struct minmea_sentence_zda zda;
+    struct minmea_sentence_pubx_position pubx_position;
+};
+
+struct minmea_parse_cache_entry {
+    uint64_t hash;
+    uint16_t length;
+    uint8_t checksum;
+    int8_t id;
+    union minmea_frame frame;
+};
+
+/**
+ * Direct-mapped cache of parsed frames, keyed on the sentence length, XOR
+ * checksum and a 64-bit content hash. The entries are supplied by the
+ * caller, which fixes the memory budget.
+ */
+struct minmea_parse_cache {
+    struct minmea_parse_cache_entry *entries;
+    size_t mask;
+    unsigned long hits;
+    unsigned long misses;
+};
+
 /**
  * Calculate raw sentence checksum. Does not check sentence integrity.
  */
@@ -232,6 +472,94 @@ bool minmea_parse_gst(struct minmea_sentence_gst *frame, const char *sentence);
 bool minmea_parse_gsv(struct minmea_sentence_gsv *frame, const char *sentence);
 bool minmea_parse_vtg(struct minmea_sentence_vtg *frame, const char *sentence);
 bool minmea_parse_zda(struct minmea_sentence_zda *frame, const char *sentence);
+bool minmea_parse_pubx_position(struct minmea_sentence_pubx_position *frame, const char *sentence);
+bool minmea_parse_vdm(struct minmea_sentence_vdm *frame, const char *sentence);
+
+/**
+ * Initialize a long sentence pool with all slots free.
+ */
+void minmea_long_pool_init(struct minmea_long_pool *pool);
+
+/**
+ * Borrow a slot from the pool. Returns the slot index, or -1 if exhausted.
+ */
+int minmea_long_pool_alloc(struct minmea_long_pool *pool);
+
+/**
+ * Return a slot to the pool.
+ */
+void minmea_long_pool_free(struct minmea_long_pool *pool, int slot);
+
+/**
+ * Initialize a framer. Without a pool, sentences longer than
+ * MINMEA_MAX_SENTENCE_LENGTH are dropped and counted in overflows.
+ */
+void minmea_framer_init(struct minmea_framer *framer, struct minmea_long_pool *pool);
+
+/**
+ * Reset the framer, dropping any partially assembled sentence.
+ */
+void minmea_framer_reset(struct minmea_framer *framer);
+
+/**
+ * Hand binary frames to a callback instead of silently skipping them.
+ */
+void minmea_framer_set_binary(struct minmea_framer *framer, minmea_binary_cb callback, void *user);
+
+/**
+ * Feed raw bytes to the framer. Consumes input up to and including the end of
+ * the first complete sentence and stores it (NUL-terminated, without line
+ * ending) in *sentence, or NULL if more input is needed. The sentence stays
+ * valid until the next call. Returns the number of bytes consumed.
+ */
+size_t minmea_framer_push(struct minmea_framer *framer, const char *data, size_t length, const char **sentence);
+
+/**
+ * Initialize a deduplication cache. prefer lists talker identifiers from most
+ * to least preferred (e.g. "GNGPGLGA"); talkers not listed rank last.
+ * Entries expire after max_age further sentences, or never if zero.
+ */
+void minmea_dedup_init(struct minmea_dedup *dedup, const char *prefer, uint32_t max_age);
+
+/**
+ * Check a sentence against the cache before parsing it. Returns false for
+ * exact or cross-talker duplicates of a cached sentence, so only one copy of
+ * an epoch is accepted. Once a talker has been seen repeating a more
+ * preferred talker's copies of a type, its sentences of that type are dropped
+ * whichever copy arrives first, until the preferred talker has not sent the
+ * type for max_age sentences.
+ */
+bool minmea_dedup_accept(struct minmea_dedup *dedup, const char *sentence);
+
+/**
+ * Check and parse any supported sentence. Returns its identifier, or
+ * MINMEA_INVALID / MINMEA_UNKNOWN if it couldn't be parsed. AIS sentences
+ * have no frame member and return MINMEA_UNKNOWN; use minmea_parse_vdm().
+ */
+enum minmea_sentence_id minmea_parse(union minmea_frame *frame, const char *sentence, bool strict);
+
+/**
+ * Initialize a parse cache over count entries. Returns false, leaving the
+ * cache unusable, if count is not a power of two.
+ */
+bool minmea_parse_cache_init(struct minmea_parse_cache *cache, struct minmea_parse_cache_entry *entries, size_t count);
+
+/**
+ * Like minmea_parse(), but returns the cached frame for a sentence that is
+ * byte-identical to one parsed before.
+ */
+enum minmea_sentence_id minmea_parse_cached(struct minmea_parse_cache *cache, union minmea_frame *frame, const char *sentence, bool strict);
+
+/**
+ * Fraction of minmea_parse_cached() calls served from the cache.
+ */
+static inline float minmea_parse_cache_hit_rate(const struct minmea_parse_cache *cache)
+{
+    unsigned long total = cache->hits + cache->misses;
+    if (total == 0)
+        return 0;
+    return (float) cache->hits / (float) total;
+}
 
 /**
  * Convert GPS UTC date/time representation to a UNIX calendar time.
@@ -243,6 +571,58 @@ int minmea_getdatetime(struct tm *tm, const struct minmea_date *date, const stru
  */
 int minmea_gettime(struct timespec *ts, const struct minmea_date *date, const struct minmea_time *time_);
 
+/**
+ * Convert a date to the number of days since 1970-01-01.
+ * Returns -1 for "unknown" dates.
+ */
+int_least32_t minmea_daynumber(const struct minmea_date *date);
+
+/**
+ * Convert a time stamp to microseconds since midnight.
+ * Returns -1 for "unknown" times.
+ */
+static inline int_least64_t minmea_time_us(const struct minmea_time *time_)
+{
+    if (time_->hours == -1)
+        return -1;
+    return ((int_least64_t) (time_->hours * 60 + time_->minutes) * 60 + time_->seconds) * 1000000 + time_->microseconds;
+}
+
+/**
+ * Extract the time stamp and, where the sentence carries one, the date of a
+ * sentence without fully parsing it. Missing fields are set to -1.
+ * Returns false for sentences that carry no time stamp.
+ */
+bool minmea_sentence_time(struct minmea_date *date, struct minmea_time *time_, const char *sentence);
+
+/**
+ * Packed representations of time stamps, dates, coordinates and fixed-point
+ * values, see struct minmea_packed_gga. Time stamps are truncated to whole
+ * milliseconds; unpacked dates carry four-digit years.
+ */
+uint32_t minmea_pack_time(const struct minmea_time *time_);
+void minmea_unpack_time(struct minmea_time *time_, uint32_t time_ms);
+uint16_t minmea_pack_date(const struct minmea_date *date);
+void minmea_unpack_date(struct minmea_date *date, uint16_t day);
+int32_t minmea_pack_coord(const struct minmea_float *f);
+void minmea_unpack_coord(struct minmea_float *f, int32_t coord);
+int32_t minmea_pack_float(const struct minmea_float *f, int32_t scale);
+void minmea_unpack_float(struct minmea_float *f, int32_t value, int32_t scale);
+
+/**
+ * Convert between full and packed frames.
+ */
+void minmea_pack_gga(struct minmea_packed_gga *packed, const struct minmea_sentence_gga *frame);
+void minmea_unpack_gga(struct minmea_sentence_gga *frame, const struct minmea_packed_gga *packed);
+void minmea_pack_rmc(struct minmea_packed_rmc *packed, const struct minmea_sentence_rmc *frame);
+void minmea_unpack_rmc(struct minmea_sentence_rmc *frame, const struct minmea_packed_rmc *packed);
+
+/**
+ * Parse a sentence into a packed frame. Return true on success.
+ */
+bool minmea_parse_gga_packed(struct minmea_packed_gga *packed, const char *sentence);
+bool minmea_parse_rmc_packed(struct minmea_packed_rmc *packed, const char *sentence);
+
 /**
  * Rescale a fixed-point value to a different scale. Rounds towards zero.
  */
@@ -286,6 +666,20 @@ static inline float minmea_tocoord(const struct minmea_float *f)
     return (float) degrees + (float) minutes / (60 * f->scale);
 }
 
+/**
+ * Like minmea_tocoord(), in double precision: float only resolves about a
+ * meter at these magnitudes.
+ */
+static inline double minmea_tocoord_double(const struct minmea_float *f)
+{
+    if (f->scale == 0)
+        return NAN;
+    int_least64_t scale = (int_least64_t) f->scale * 100;
+    int_least64_t degrees = f->value / scale;
+    int_least64_t minutes = f->value % scale;
+    return (double) degrees + (double) minutes / (60.0 * f->scale);
+}
+
 /**
  * Check whether a character belongs to the set of characters allowed in a
  * sentence data field.
@@ -0,0 +1,273 @@
+/**
+ * @file nmea_ais.c
+ * @brief AIS message reassembly and decoding.
+ * @author wwk (1162431386@qq.com)
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2024  by  xxx
+ *
+ * @par 修改日志:
+ * <table>
+ * <tr><th>Date       <th>Version <th>Author  <th>Description
+ * <tr><td>2026-10-19     <td>1.0     <td>wwk   <td>新建
+ * </table>
+ */
+#include "nmea_ais.h"
+
+#include <string.h>
+
+// Armored payload character to 6-bit value, 0xff for invalid characters.
+static const uint8_t armor[256] = {
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+    0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f,
+    0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0x28, 0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37,
+    0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0x3e, 0x3f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+};
+
+static void message_reset(struct minmea_ais_message *msg, char channel)
+{
+    memset(msg->bits, 0, sizeof(msg->bits));
+    msg->bit_length = 0;
+    msg->channel = channel;
+}
+
+/**
+ * Append the de-armored payload of a fragment. Returns false on invalid
+ * characters or overlong messages.
+ */
+static bool message_append(struct minmea_ais_message *msg, const struct minmea_sentence_vdm *frame, bool last)
+{
+    const uint8_t *p = (const uint8_t *) frame->payload;
+    size_t n = frame->payload_length;
+    size_t pos = msg->bit_length;
+
+    if (pos + 6 * n > MINMEA_AIS_MAX_BITS)
+        return false;
+
+    // Four characters make three bytes while byte-aligned.
+    while (n >= 4 && (pos & 7) == 0) {
+        uint32_t a = armor[p[0]], b = armor[p[1]], c = armor[p[2]], d = armor[p[3]];
+        if ((a | b | c | d) & 0xc0)
+            return false;
+        uint32_t word = a << 18 | b << 12 | c << 6 | d;
+        uint8_t *out = msg->bits + (pos >> 3);
+        out[0] = word >> 16;
+        out[1] = word >> 8;
+        out[2] = word;
+        pos += 24;
+        p += 4;
+        n -= 4;
+    }
+
+    while (n--) {
+        uint32_t v = armor[*p++];
+        if (v & 0xc0)
+            return false;
+        uint8_t *out = msg->bits + (pos >> 3);
+        unsigned shift = pos & 7;
+        if (shift <= 2) {
+            out[0] |= v << (2 - shift);
+        } else {
+            out[0] |= v >> (shift - 2);
+            out[1] |= (uint8_t) (v << (10 - shift));
+        }
+        pos += 6;
+    }
+
+    if (last) {
+        if ((size_t) frame->fill_bits > pos)
+            return false;
+        pos -= frame->fill_bits;
+        // Clear the fill bits so they read as zero.
+        msg->bits[pos >> 3] &= (uint8_t) (0xff00 >> (pos & 7));
+        memset(msg->bits + (pos >> 3) + 1, 0, sizeof(msg->bits) - (pos >> 3) - 1);
+    }
+
+    msg->bit_length = pos;
+    return true;
+}
+
+void minmea_ais_assembler_init(struct minmea_ais_assembler *assembler)
+{
+    for (int i = 0; i < 10; i++)
+        assembler->next_fragment[i] = 0;
+    assembler->dropped = 0;
+}
+
+int minmea_ais_assemble(struct minmea_ais_assembler *assembler, struct minmea_ais_message *msg,
+        const struct minmea_sentence_vdm *frame)
+{
+    if (frame->fragment_count == 1) {
+        message_reset(msg, frame->channel);
+        return message_append(msg, frame, true) ? 1 : -1;
+    }
+
+    if (frame->message_id < 0 || frame->message_id > 9)
+        return -1;
+
+    int id = frame->message_id;
+    struct minmea_ais_message *slot = &assembler->slots[id];
+
+    if (frame->fragment_number == 1) {
+        if (assembler->next_fragment[id])
+            assembler->dropped++;
+        message_reset(slot, frame->channel);
+    } else if (frame->fragment_number != assembler->next_fragment[id] || frame->channel != slot->channel) {
+        if (assembler->next_fragment[id])
+            assembler->dropped++;
+        assembler->next_fragment[id] = 0;
+        return -1;
+    }
+
+    bool last = frame->fragment_number == frame->fragment_count;
+    if (!message_append(slot, frame, last)) {
+        assembler->next_fragment[id] = 0;
+        assembler->dropped++;
+        return -1;
+    }
+
+    if (!last) {
+        assembler->next_fragment[id] = frame->fragment_number + 1;
+        return 0;
+    }
+
+    assembler->next_fragment[id] = 0;
+    *msg = *slot;
+    return 1;
+}
+
+int minmea_ais_type(const struct minmea_ais_message *msg)
+{
+    if (msg->bit_length < 6)
+        return -1;
+    return minmea_ais_uint(msg, 0, 6);
+}
+
+/**
+ * Decode six-bit ASCII text, dropping trailing "@" padding and spaces.
+ */
+static void ais_text(char *out, const struct minmea_ais_message *msg, unsigned start, unsigned chars)
+{
+    unsigned length = 0;
+
+    for (unsigned i = 0; i < chars; i++) {
+        uint32_t v = minmea_ais_uint(msg, start + 6 * i, 6);
+        out[i] = v < 32 ? v + 64 : v;
+        if (out[i] != '@' && out[i] != ' ')
+            length = i + 1;
+    }
+
+    out[length] = '\0';
+}
+
+bool minmea_ais_decode_position(struct minmea_ais_position *position, const struct minmea_ais_message *msg)
+{
+    int type = minmea_ais_type(msg);
+
+    position->type = type;
+    position->repeat = minmea_ais_uint(msg, 6, 2);
+    position->mmsi = minmea_ais_uint(msg, 8, 30);
+
+    if (type >= 1 && type <= 3) {
+        if (msg->bit_length < 149)
+            return false;
+        position->nav_status = minmea_ais_uint(msg, 38, 4);
+        position->rot = minmea_ais_int(msg, 42, 8);
+        position->sog = minmea_ais_uint(msg, 50, 10);
+        position->accuracy = minmea_ais_uint(msg, 60, 1);
+        position->longitude = minmea_ais_int(msg, 61, 28);
+        position->latitude = minmea_ais_int(msg, 89, 27);
+        position->cog = minmea_ais_uint(msg, 116, 12);
+        position->heading = minmea_ais_uint(msg, 128, 9);
+        position->second = minmea_ais_uint(msg, 137, 6);
+        return true;
+    }
+
+    if (type == 18) {
+        if (msg->bit_length < 139)
+            return false;
+        position->nav_status = 15;
+        position->rot = -128;
+        position->sog = minmea_ais_uint(msg, 46, 10);
+        position->accuracy = minmea_ais_uint(msg, 56, 1);
+        position->longitude = minmea_ais_int(msg, 57, 28);
+        position->latitude = minmea_ais_int(msg, 85, 27);
+        position->cog = minmea_ais_uint(msg, 112, 12);
+        position->heading = minmea_ais_uint(msg, 124, 9);
+        position->second = minmea_ais_uint(msg, 133, 6);
+        return true;
+    }
+
+    return false;
+}
+
+bool minmea_ais_decode_static(struct minmea_ais_static *data, const struct minmea_ais_message *msg)
+{
+    int type = minmea_ais_type(msg);
+
+    memset(data, 0, sizeof(*data));
+    data->type = type;
+    data->repeat = minmea_ais_uint(msg, 6, 2);
+    data->mmsi = minmea_ais_uint(msg, 8, 30);
+    data->part = -1;
+
+    if (type == 5) {
+        if (msg->bit_length < 422)
+            return false;
+        data->imo = minmea_ais_uint(msg, 40, 30);
+        ais_text(data->callsign, msg, 70, 7);
+        ais_text(data->name, msg, 112, 20);
+        data->ship_type = minmea_ais_uint(msg, 232, 8);
+        data->to_bow = minmea_ais_uint(msg, 240, 9);
+        data->to_stern = minmea_ais_uint(msg, 249, 9);
+        data->to_port = minmea_ais_uint(msg, 258, 6);
+        data->to_starboard = minmea_ais_uint(msg, 264, 6);
+        data->eta_month = minmea_ais_uint(msg, 274, 4);
+        data->eta_day = minmea_ais_uint(msg, 278, 5);
+        data->eta_hour = minmea_ais_uint(msg, 283, 5);
+        data->eta_minute = minmea_ais_uint(msg, 288, 6);
+        data->draught = minmea_ais_uint(msg, 294, 8);
+        ais_text(data->destination, msg, 302, 20);
+        return true;
+    }
+
+    if (type == 24) {
+        if (msg->bit_length < 40)
+            return false;
+        data->part = minmea_ais_uint(msg, 38, 2);
+        if (data->part == 0) {
+            if (msg->bit_length < 160)
+                return false;
+            ais_text(data->name, msg, 40, 20);
+            return true;
+        }
+        if (data->part == 1) {
+            if (msg->bit_length < 162)
+                return false;
+            data->ship_type = minmea_ais_uint(msg, 40, 8);
+            ais_text(data->callsign, msg, 90, 7);
+            data->to_bow = minmea_ais_uint(msg, 132, 9);
+            data->to_stern = minmea_ais_uint(msg, 141, 9);
+            data->to_port = minmea_ais_uint(msg, 150, 6);
+            data->to_starboard = minmea_ais_uint(msg, 156, 6);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* vim: set ts=4 sw=4 et: */
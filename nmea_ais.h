@@ -0,0 +1,130 @@
+/**
+ * @file nmea_ais.h
+ * @brief AIS message reassembly and decoding.
+ * @author wwk (1162431386@qq.com)
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2024  by  xxx
+ *
+ * @par 修改日志:
+ * <table>
+ * <tr><th>Date       <th>Version <th>Author  <th>Description
+ * <tr><td>2026-10-19     <td>1.0     <td>wwk   <td>新建
+ * </table>
+ */
+
+#ifndef MINMEA_AIS_H
+#define MINMEA_AIS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+#include "nmea.h"
+
+// Longest AIS message (five slots).
+#define MINMEA_AIS_MAX_BITS 1008
+
+/**
+ * De-armored AIS message bits, most significant bit first. The buffer is
+ * padded so fields can be read with unaligned 64-bit loads; bits past
+ * bit_length read as zero.
+ */
+struct minmea_ais_message {
+    uint8_t bits[MINMEA_AIS_MAX_BITS / 8 + 8];
+    size_t bit_length;
+    char channel;
+};
+
+/**
+ * Reassembly of multi-fragment messages, one slot per sequential message
+ * identifier.
+ */
+struct minmea_ais_assembler {
+    struct minmea_ais_message slots[10];
+    int8_t next_fragment[10];
+    unsigned long dropped;
+};
+
+// Position report (message types 1, 2, 3 and 18).
+struct minmea_ais_position {
+    int type;
+    int repeat;
+    uint32_t mmsi;
+    int nav_status;         // 15 if not available (type 18)
+    int rot;                // raw rate of turn, -128 if not available
+    int sog;                // 1/10 knot, 1023 if not available
+    bool accuracy;
+    int32_t longitude;      // 1/10000 minute, 181 degrees if not available
+    int32_t latitude;       // 1/10000 minute, 91 degrees if not available
+    int cog;                // 1/10 degree, 3600 if not available
+    int heading;            // degrees, 511 if not available
+    int second;
+};
+
+// Static data (message types 5 and 24).
+struct minmea_ais_static {
+    int type;
+    int repeat;
+    uint32_t mmsi;
+    int part;               // type 24 part number, -1 for type 5
+    uint32_t imo;
+    char callsign[8];
+    char name[21];
+    int ship_type;
+    int to_bow, to_stern, to_port, to_starboard;
+    int eta_month, eta_day, eta_hour, eta_minute;
+    int draught;            // 1/10 meter
+    char destination[21];
+};
+
+/**
+ * Read an unsigned or two's complement field of up to 32 bits.
+ */
+static inline uint32_t minmea_ais_uint(const struct minmea_ais_message *msg, unsigned start, unsigned width)
+{
+    const uint8_t *p = msg->bits + (start >> 3);
+    uint64_t word = (uint64_t) p[0] << 56 | (uint64_t) p[1] << 48 | (uint64_t) p[2] << 40 |
+                    (uint64_t) p[3] << 32 | (uint64_t) p[4] << 24 | (uint64_t) p[5] << 16 |
+                    (uint64_t) p[6] << 8 | (uint64_t) p[7];
+    return (uint32_t) ((word << (start & 7)) >> (64 - width));
+}
+
+static inline int32_t minmea_ais_int(const struct minmea_ais_message *msg, unsigned start, unsigned width)
+{
+    uint32_t value = minmea_ais_uint(msg, start, width);
+    uint32_t sign = UINT32_C(1) << (width - 1);
+    return (int32_t) ((value ^ sign) - sign);
+}
+
+void minmea_ais_assembler_init(struct minmea_ais_assembler *assembler);
+
+/**
+ * Add a parsed VDM/VDO fragment. Returns 1 and fills msg once a message is
+ * complete, 0 while fragments are outstanding and -1 for fragments that are
+ * malformed or out of sequence.
+ */
+int minmea_ais_assemble(struct minmea_ais_assembler *assembler, struct minmea_ais_message *msg,
+        const struct minmea_sentence_vdm *frame);
+
+/**
+ * Message type, or -1 for an empty message.
+ */
+int minmea_ais_type(const struct minmea_ais_message *msg);
+
+/**
+ * Decode a message into a fixed struct. Return true on success.
+ */
+bool minmea_ais_decode_position(struct minmea_ais_position *position, const struct minmea_ais_message *msg);
+bool minmea_ais_decode_static(struct minmea_ais_static *data, const struct minmea_ais_message *msg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MINMEA_AIS_H */
+
+/* vim: set ts=4 sw=4 et: */
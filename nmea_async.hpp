@@ -0,0 +1,290 @@
+/**
+ * @file nmea_async.hpp
+ * @brief C++20 coroutine layer for reading parsed sentences from descriptors.
+ * @author wwk (1162431386@qq.com)
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2024  by  xxx
+ *
+ * @par 修改日志:
+ * <table>
+ * <tr><th>Date       <th>Version <th>Author  <th>Description
+ * <tr><td>2026-10-19     <td>1.0     <td>wwk   <td>新建
+ * </table>
+ */
+
+#ifndef MINMEA_ASYNC_HPP
+#define MINMEA_ASYNC_HPP
+
+#include <cerrno>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <optional>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include "nmea_feed.h"
+
+/*
+ * A single-threaded epoll executor serving any number of feeds:
+ *
+ *     minmea::executor ex;
+ *     minmea::async_feed gps(ex, fd);
+ *     ex.spawn([](minmea::async_feed &feed) -> minmea::task<void> {
+ *         while (auto s = co_await feed.next())
+ *             if (s->id == MINMEA_SENTENCE_GGA)
+ *                 use(s->frame.gga);
+ *     }(gps));
+ *     ex.run();
+ */
+
+namespace minmea {
+
+/**
+ * Lazily started coroutine producing a T; awaiting it runs it to completion
+ * and resumes the awaiter.
+ */
+template <typename T>
+class task {
+public:
+    struct promise_type;
+    using handle = std::coroutine_handle<promise_type>;
+
+    struct final_awaiter {
+        bool await_ready() noexcept { return false; }
+        std::coroutine_handle<> await_suspend(handle h) noexcept
+        {
+            auto next = h.promise().continuation;
+            return next ? next : std::noop_coroutine();
+        }
+        void await_resume() noexcept {}
+    };
+
+    struct promise_base {
+        std::coroutine_handle<> continuation;
+        std::exception_ptr error;
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        final_awaiter final_suspend() noexcept { return {}; }
+        void unhandled_exception() { error = std::current_exception(); }
+    };
+
+    struct promise_type : promise_base {
+        std::optional<T> value;
+
+        task get_return_object() { return task(handle::from_promise(*this)); }
+        template <typename U>
+        void return_value(U &&v) { value.emplace(std::forward<U>(v)); }
+    };
+
+    task(task &&other) noexcept : h_(std::exchange(other.h_, {})) {}
+    task(const task &) = delete;
+    task &operator=(const task &) = delete;
+    ~task() { if (h_) h_.destroy(); }
+
+    bool await_ready() const noexcept { return false; }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiter) noexcept
+    {
+        h_.promise().continuation = awaiter;
+        return h_;
+    }
+    T await_resume()
+    {
+        if (h_.promise().error)
+            std::rethrow_exception(h_.promise().error);
+        return std::move(*h_.promise().value);
+    }
+
+private:
+    explicit task(handle h) : h_(h) {}
+    handle h_;
+};
+
+template <>
+struct task<void>::promise_type : task<void>::promise_base {
+    task get_return_object() { return task(handle::from_promise(*this)); }
+    void return_void() {}
+};
+
+template <>
+inline void task<void>::await_resume()
+{
+    if (h_.promise().error)
+        std::rethrow_exception(h_.promise().error);
+}
+
+/**
+ * Runs spawned tasks and resumes them when their descriptors turn readable.
+ */
+class executor {
+public:
+    executor() : epfd_(epoll_create1(EPOLL_CLOEXEC))
+    {
+        if (epfd_ == -1)
+            throw std::system_error(errno, std::generic_category(), "epoll_create1");
+    }
+    ~executor() { close(epfd_); }
+    executor(const executor &) = delete;
+    executor &operator=(const executor &) = delete;
+
+    /**
+     * Start a task on the next run() iteration. The executor owns it.
+     */
+    void spawn(task<void> t)
+    {
+        live_++;
+        detach(std::move(t), *this);
+    }
+
+    /**
+     * Run until every spawned task has finished.
+     */
+    void run()
+    {
+        epoll_event events[64];
+
+        for (;;) {
+            while (!ready_.empty()) {
+                auto h = ready_.front();
+                ready_.pop_front();
+                h.resume();
+            }
+            if (live_ == 0)
+                return;
+
+            int n = epoll_wait(epfd_, events, 64, -1);
+            if (n == -1) {
+                if (errno == EINTR)
+                    continue;
+                throw std::system_error(errno, std::generic_category(), "epoll_wait");
+            }
+            for (int i = 0; i < n; i++) {
+                auto *w = static_cast<std::coroutine_handle<> *>(events[i].data.ptr);
+                if (*w)
+                    ready_.push_back(std::exchange(*w, {}));
+            }
+        }
+    }
+
+    /**
+     * Deliver readiness of fd to *waiter (edge-triggered).
+     */
+    void watch(int fd, std::coroutine_handle<> *waiter)
+    {
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLRDHUP | EPOLLET;
+        ev.data.ptr = waiter;
+        if (epoll_ctl(epfd_, EPOLL_CTL_ADD, fd, &ev) == -1)
+            throw std::system_error(errno, std::generic_category(), "epoll_ctl");
+    }
+
+    void unwatch(int fd) { epoll_ctl(epfd_, EPOLL_CTL_DEL, fd, nullptr); }
+
+private:
+    struct detached {
+        struct promise_type {
+            detached get_return_object() { return {}; }
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() {}
+            void unhandled_exception() { std::terminate(); }
+        };
+    };
+
+    struct yield {
+        executor &ex;
+        bool await_ready() noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> h) { ex.ready_.push_back(h); }
+        void await_resume() noexcept {}
+    };
+
+    static detached detach(task<void> t, executor &ex)
+    {
+        co_await yield{ex};
+        co_await t;
+        ex.live_--;
+    }
+
+    int epfd_;
+    size_t live_ = 0;
+    std::deque<std::coroutine_handle<>> ready_;
+};
+
+/**
+ * A parsed sentence. raw stays valid until the next call on its feed.
+ */
+struct sentence {
+    enum minmea_sentence_id id;
+    union minmea_frame frame;
+    std::string_view raw;
+};
+
+/**
+ * Descriptor (tty, socket or pipe) yielding parsed sentences.
+ */
+class async_feed {
+public:
+    async_feed(executor &ex, int fd, bool strict = false, minmea_long_pool *pool = nullptr)
+        : ex_(ex), strict_(strict)
+    {
+        if (minmea_feed_init(&feed_, fd, pool) == -1)
+            throw std::system_error(errno, std::generic_category(), "minmea_feed_init");
+        ex_.watch(fd, &waiter_);
+    }
+    ~async_feed()
+    {
+        ex_.unwatch(feed_.fd);
+        minmea_feed_release(&feed_);
+    }
+    async_feed(const async_feed &) = delete;
+    async_feed &operator=(const async_feed &) = delete;
+
+    /**
+     * Next sentence, or nullopt at end of input. Unparseable sentences are
+     * returned with id MINMEA_INVALID or MINMEA_UNKNOWN.
+     */
+    task<std::optional<sentence>> next()
+    {
+        for (;;) {
+            const char *s;
+            int r = minmea_feed_next(&feed_, &s);
+            if (r > 0) {
+                sentence out;
+                out.raw = s;
+                out.id = minmea_parse(&out.frame, s, strict_);
+                co_return out;
+            }
+            if (r < 0) {
+                if (errno)
+                    throw std::system_error(errno, std::generic_category(), "read");
+                co_return std::nullopt;
+            }
+            co_await readable{this};
+        }
+    }
+
+private:
+    struct readable {
+        async_feed *feed;
+        bool await_ready() noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> h) noexcept { feed->waiter_ = h; }
+        void await_resume() noexcept {}
+    };
+
+    executor &ex_;
+    bool strict_;
+    std::coroutine_handle<> waiter_;
+    minmea_feed feed_;
+};
+
+} // namespace minmea
+
+#endif /* MINMEA_ASYNC_HPP */
+
+/* vim: set ts=4 sw=4 et: */
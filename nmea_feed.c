@@ -0,0 +1,78 @@
+/**
+ * @file nmea_feed.c
+ * @brief Non-blocking sentence input from file descriptors.
+ * @author wwk (1162431386@qq.com)
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2024  by  xxx
+ *
+ * @par 修改日志:
+ * <table>
+ * <tr><th>Date       <th>Version <th>Author  <th>Description
+ * <tr><td>2026-10-19     <td>1.0     <td>wwk   <td>新建
+ * </table>
+ */
+#include "nmea_feed.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+int minmea_feed_init(struct minmea_feed *feed, int fd, struct minmea_long_pool *pool)
+{
+    feed->fd = fd;
+    feed->eof = false;
+    feed->pos = 0;
+    feed->length = 0;
+    minmea_framer_init(&feed->framer, pool);
+
+    int flags = fcntl(fd, F_GETFL);
+    if (flags == -1 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) == -1)
+        return -1;
+
+    return 0;
+}
+
+void minmea_feed_release(struct minmea_feed *feed)
+{
+    minmea_framer_reset(&feed->framer);
+    feed->pos = 0;
+    feed->length = 0;
+}
+
+int minmea_feed_next(struct minmea_feed *feed, const char **sentence)
+{
+    for (;;) {
+        while (feed->pos < feed->length) {
+            feed->pos += minmea_framer_push(&feed->framer, feed->buf + feed->pos,
+                                            feed->length - feed->pos, sentence);
+            if (*sentence)
+                return 1;
+        }
+
+        if (feed->eof) {
+            errno = 0;
+            return -1;
+        }
+
+        ssize_t n = read(feed->fd, feed->buf, sizeof(feed->buf));
+        if (n > 0) {
+            feed->pos = 0;
+            feed->length = n;
+        } else if (n == 0) {
+            feed->eof = true;
+        } else if (errno == EINTR) {
+            continue;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return 0;
+        } else if (errno == EIO) {
+            // A pty whose other side has closed.
+            feed->eof = true;
+        } else {
+            return -1;
+        }
+    }
+}
+
+/* vim: set ts=4 sw=4 et: */
@@ -0,0 +1,71 @@
+/**
+ * @file nmea_feed.h
+ * @brief Non-blocking sentence input from file descriptors.
+ * @author wwk (1162431386@qq.com)
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2024  by  xxx
+ *
+ * @par 修改日志:
+ * <table>
+ * <tr><th>Date       <th>Version <th>Author  <th>Description
+ * <tr><td>2026-10-19     <td>1.0     <td>wwk   <td>新建
+ * </table>
+ */
+
+#ifndef MINMEA_FEED_H
+#define MINMEA_FEED_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+#include "nmea.h"
+
+#ifndef MINMEA_FEED_BUFFER_SIZE
+#define MINMEA_FEED_BUFFER_SIZE 4096
+#endif
+
+/**
+ * A tty, socket or pipe read in non-blocking mode through a framer. Meant
+ * to be driven by an event loop (see nmea_async.hpp for a C++20 one).
+ */
+struct minmea_feed {
+    int fd;
+    bool eof;
+    size_t pos;
+    size_t length;
+    struct minmea_framer framer;
+    char buf[MINMEA_FEED_BUFFER_SIZE];
+};
+
+/**
+ * Attach a feed to a file descriptor and switch it to non-blocking mode.
+ * Returns 0 on success, -1 on error (errno is set).
+ */
+int minmea_feed_init(struct minmea_feed *feed, int fd, struct minmea_long_pool *pool);
+
+/**
+ * Detach a feed, dropping any partial sentence and returning its long
+ * sentence slot to the pool. The descriptor is left open.
+ */
+void minmea_feed_release(struct minmea_feed *feed);
+
+/**
+ * Fetch the next complete sentence, reading until the descriptor would
+ * block. Returns 1 with *sentence set (valid until the next call), 0 if more
+ * input is needed, or -1 at end of file or on error (errno is set, 0 at end
+ * of file).
+ */
+int minmea_feed_next(struct minmea_feed *feed, const char **sentence);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MINMEA_FEED_H */
+
+/* vim: set ts=4 sw=4 et: */
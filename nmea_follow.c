@@ -0,0 +1,230 @@
+/**
+ * @file nmea_follow.c
+ * @brief Incremental reading of log files that are still being written.
+ * @author wwk (1162431386@qq.com)
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2024  by  xxx
+ *
+ * @par 修改日志:
+ * <table>
+ * <tr><th>Date       <th>Version <th>Author  <th>Description
+ * <tr><td>2026-10-19     <td>1.0     <td>wwk   <td>新建
+ * </table>
+ */
+#include "nmea_follow.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define FILE_EVENTS (IN_MODIFY | IN_ATTRIB | IN_MOVE_SELF | IN_DELETE_SELF)
+#define DIR_EVENTS (IN_CREATE | IN_MOVED_TO)
+
+/**
+ * Switch to whatever file is now at the path. Returns 1 if one was opened, 0
+ * if there is none yet, -1 on error.
+ */
+static int follow_reopen(struct minmea_follow *follow)
+{
+    int fd = open(follow->path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+        return errno == ENOENT ? 0 : -1;
+
+    struct stat st;
+    if (fstat(fd, &st) == -1) {
+        close(fd);
+        return -1;
+    }
+
+    if (follow->fd != -1)
+        close(follow->fd);
+    if (follow->file_watch != -1)
+        inotify_rm_watch(follow->inotify, follow->file_watch);
+
+    follow->fd = fd;
+    follow->dev = st.st_dev;
+    follow->ino = st.st_ino;
+    follow->buf_offset = 0;
+    follow->offset = 0;
+    follow->pos = 0;
+    follow->length = 0;
+    follow->file_watch = inotify_add_watch(follow->inotify, follow->path, FILE_EVENTS);
+    minmea_framer_reset(&follow->framer);
+
+    return 1;
+}
+
+int minmea_follow_open(struct minmea_follow *follow, const char *path, off_t offset,
+                       struct minmea_long_pool *pool)
+{
+    follow->fd = -1;
+    follow->inotify = -1;
+    follow->file_watch = -1;
+    // Set here as well: a file that does not exist yet is not opened below.
+    follow->buf_offset = 0;
+    follow->offset = 0;
+    follow->pos = 0;
+    follow->length = 0;
+    follow->rotations = 0;
+    follow->truncations = 0;
+    minmea_framer_init(&follow->framer, pool);
+
+    follow->path = strdup(path);
+    if (!follow->path)
+        return -1;
+
+    follow->inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (follow->inotify == -1)
+        goto fail;
+
+    // Watch the directory as well, to see a rotated file's replacement.
+    char dir[PATH_MAX];
+    const char *slash = strrchr(path, '/');
+    if (!slash) {
+        strcpy(dir, ".");
+    } else if (slash == path) {
+        strcpy(dir, "/");
+    } else if ((size_t) (slash - path) < sizeof(dir)) {
+        memcpy(dir, path, slash - path);
+        dir[slash - path] = '\0';
+    } else {
+        errno = ENAMETOOLONG;
+        goto fail;
+    }
+    if (inotify_add_watch(follow->inotify, dir, DIR_EVENTS) == -1)
+        goto fail;
+
+    int r = follow_reopen(follow);
+    if (r == -1)
+        goto fail;
+
+    if (r == 1 && offset > 0) {
+        struct stat st;
+        if (fstat(follow->fd, &st) == -1)
+            goto fail;
+        if (offset <= st.st_size) {
+            if (lseek(follow->fd, offset, SEEK_SET) == -1)
+                goto fail;
+            follow->buf_offset = offset;
+            follow->offset = offset;
+        } else {
+            // Truncated since the offset was saved.
+            follow->truncations++;
+        }
+    }
+
+    return 0;
+
+fail:
+    minmea_follow_close(follow);
+    return -1;
+}
+
+void minmea_follow_close(struct minmea_follow *follow)
+{
+    int saved = errno;
+
+    if (follow->fd != -1)
+        close(follow->fd);
+    if (follow->inotify != -1)
+        close(follow->inotify);
+    // Give back a long sentence slot held by a partial line.
+    minmea_framer_reset(&follow->framer);
+    free(follow->path);
+    follow->fd = -1;
+    follow->inotify = -1;
+    follow->path = NULL;
+
+    errno = saved;
+}
+
+int minmea_follow_next(struct minmea_follow *follow, const char **sentence)
+{
+    *sentence = NULL;
+
+    for (;;) {
+        while (follow->pos < follow->length) {
+            follow->pos += minmea_framer_push(&follow->framer, follow->buf + follow->pos,
+                                              follow->length - follow->pos, sentence);
+            if (*sentence) {
+                follow->offset = follow->buf_offset + follow->pos;
+                return 1;
+            }
+        }
+
+        if (follow->fd == -1) {
+            int r = follow_reopen(follow);
+            if (r <= 0)
+                return r;
+            continue;
+        }
+
+        follow->buf_offset += follow->length;
+        follow->pos = 0;
+        follow->length = 0;
+
+        ssize_t n = read(follow->fd, follow->buf, sizeof(follow->buf));
+        if (n > 0) {
+            follow->length = n;
+            continue;
+        }
+        if (n == -1) {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+
+        // At the end of the file: it may have been cut short or replaced.
+        struct stat st;
+        if (fstat(follow->fd, &st) == -1)
+            return -1;
+        if (st.st_size < follow->buf_offset) {
+            if (lseek(follow->fd, 0, SEEK_SET) == -1)
+                return -1;
+            follow->buf_offset = 0;
+            follow->offset = 0;
+            follow->truncations++;
+            minmea_framer_reset(&follow->framer);
+            continue;
+        }
+
+        // The old file has been drained, so switching loses nothing.
+        if (stat(follow->path, &st) == 0 && (st.st_dev != follow->dev || st.st_ino != follow->ino)) {
+            int r = follow_reopen(follow);
+            if (r == -1)
+                return -1;
+            if (r == 1) {
+                follow->rotations++;
+                continue;
+            }
+        }
+
+        return 0;
+    }
+}
+
+int minmea_follow_wait(struct minmea_follow *follow, int timeout_ms)
+{
+    struct pollfd pfd = { .fd = follow->inotify, .events = POLLIN };
+
+    int r = poll(&pfd, 1, timeout_ms);
+    if (r <= 0)
+        return r == -1 && errno == EINTR ? 0 : r;
+
+    // The events only wake us up; minmea_follow_next() looks at the file.
+    char events[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    while (read(follow->inotify, events, sizeof(events)) > 0)
+        ;
+
+    return 1;
+}
+
+/* vim: set ts=4 sw=4 et: */
@@ -0,0 +1,97 @@
+/**
+ * @file nmea_follow.h
+ * @brief Incremental reading of log files that are still being written.
+ * @author wwk (1162431386@qq.com)
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2024  by  xxx
+ *
+ * @par 修改日志:
+ * <table>
+ * <tr><th>Date       <th>Version <th>Author  <th>Description
+ * <tr><td>2026-10-19     <td>1.0     <td>wwk   <td>新建
+ * </table>
+ */
+
+#ifndef MINMEA_FOLLOW_H
+#define MINMEA_FOLLOW_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <sys/types.h>
+
+#include "nmea_feed.h"
+
+/**
+ * A log file followed like `tail -F`: appended bytes are framed as they
+ * arrive, a partial last line is kept in the framer until it is completed,
+ * and the file is reopened when it is rotated (renamed or replaced) or
+ * started over when it is truncated.
+ */
+struct minmea_follow {
+    char *path;
+    int fd;
+    int inotify;
+    int file_watch;
+    dev_t dev;
+    ino_t ino;
+    // File offset of buf[0], and just past the last returned sentence.
+    off_t buf_offset;
+    off_t offset;
+    size_t pos;
+    size_t length;
+    unsigned long rotations;
+    unsigned long truncations;
+    struct minmea_framer framer;
+    char buf[MINMEA_FEED_BUFFER_SIZE];
+};
+
+/**
+ * Start following path from offset (a value from minmea_follow_offset(), or
+ * 0). An offset past the end of the file is taken as a truncation and reading
+ * starts from the beginning. The file does not need to exist yet. Returns 0
+ * on success, -1 on error (errno is set).
+ */
+int minmea_follow_open(struct minmea_follow *follow, const char *path, off_t offset,
+                       struct minmea_long_pool *pool);
+
+/**
+ * Stop following. A partial line is dropped and its long sentence slot, if
+ * any, returned to the pool.
+ */
+void minmea_follow_close(struct minmea_follow *follow);
+
+/**
+ * Fetch the next complete sentence. Returns 1 with *sentence set (valid until
+ * the next call), 0 once all written data has been consumed, or -1 on error
+ * (errno is set).
+ */
+int minmea_follow_next(struct minmea_follow *follow, const char **sentence);
+
+/**
+ * Block until the file may have changed, or timeout_ms passes (-1 waits
+ * forever). Returns 1 on a change, 0 on timeout, -1 on error. Event loops can
+ * instead poll follow->inotify for reading and call this with a timeout of 0.
+ */
+int minmea_follow_wait(struct minmea_follow *follow, int timeout_ms);
+
+/**
+ * Offset in the current file just past the last returned sentence; reopening
+ * there resumes without losing or repeating sentences.
+ */
+static inline off_t minmea_follow_offset(const struct minmea_follow *follow)
+{
+    return follow->offset;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MINMEA_FOLLOW_H */
+
+/* vim: set ts=4 sw=4 et: */
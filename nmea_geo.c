@@ -0,0 +1,253 @@
+/**
+ * @file nmea_geo.c
+ * @brief Batch WGS-84 geodesy kernels over parsed fixes.
+ * @author wwk (1162431386@qq.com)
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2024  by  xxx
+ *
+ * @par 修改日志:
+ * <table>
+ * <tr><th>Date       <th>Version <th>Author  <th>Description
+ * <tr><td>2026-10-19     <td>1.0     <td>wwk   <td>新建
+ * </table>
+ */
+#include "nmea_geo.h"
+
+#include <math.h>
+
+// WGS-84 ellipsoid.
+#define WGS84_A     6378137.0
+#define WGS84_F     (1.0 / 298.257223563)
+#define WGS84_B     (WGS84_A * (1.0 - WGS84_F))
+#define WGS84_E2    (WGS84_F * (2.0 - WGS84_F))
+#define WGS84_EP2   (WGS84_E2 / (1.0 - WGS84_E2))
+
+// IUGG mean earth radius, used by the spherical kernels.
+#define EARTH_RADIUS 6371008.8
+
+#define DEG2RAD (M_PI / 180.0)
+#define RAD2DEG (180.0 / M_PI)
+
+// Points per block in minmea_track_distance().
+#define GEO_BLOCK 64
+
+/*
+ * glibc's libmvec has vector variants of these functions, but <math.h> only
+ * announces them under -ffast-math, which would break the NaN handling here.
+ * Declaring them directly lets the trigonometric loops vectorize as well.
+ */
+#if defined(__x86_64__) && defined(__GLIBC__) && defined(__GNUC__) && !defined(__clang__) \
+    && !defined(__FAST_MATH__) && !defined(MINMEA_GEO_NO_LIBMVEC)
+#if __GLIBC_PREREQ(2, 35)
+#define GEO_SIMD __attribute__((__simd__("notinbranch")))
+GEO_SIMD double sin(double);
+GEO_SIMD double cos(double);
+GEO_SIMD double asin(double);
+GEO_SIMD double atan2(double, double);
+GEO_SIMD double cbrt(double);
+#endif
+#endif
+
+static double geo_float(const struct minmea_float *f)
+{
+    if (f->scale == 0)
+        return NAN;
+    return (double) f->value / (double) f->scale;
+}
+
+void minmea_geo_from_gga(double *restrict lat, double *restrict lon, double *restrict height,
+        const struct minmea_sentence_gga *restrict frames, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        const struct minmea_sentence_gga *frame = &frames[i];
+        lat[i] = minmea_tocoord_double(&frame->latitude);
+        lon[i] = minmea_tocoord_double(&frame->longitude);
+        height[i] = geo_float(&frame->altitude);
+        // Missing geoid separation means the receiver reports ellipsoidal altitude.
+        if (frame->height.scale != 0)
+            height[i] += geo_float(&frame->height);
+    }
+}
+
+void minmea_geodetic_to_ecef(double *restrict x, double *restrict y, double *restrict z,
+        const double *restrict lat, const double *restrict lon, const double *restrict height,
+        size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        double phi = lat[i] * DEG2RAD;
+        double lambda = lon[i] * DEG2RAD;
+        // cos(x) as sin(x + pi/2): a sin/cos pair of one argument becomes a
+        // sincos() call, which has no vector variant.
+        double sin_phi = sin(phi), cos_phi = sin(phi + M_PI_2);
+        double n = WGS84_A / sqrt(1.0 - WGS84_E2 * sin_phi * sin_phi);
+        double r = (n + height[i]) * cos_phi;
+        x[i] = r * sin(lambda + M_PI_2);
+        y[i] = r * sin(lambda);
+        z[i] = (n * (1.0 - WGS84_E2) + height[i]) * sin_phi;
+    }
+}
+
+void minmea_ecef_to_geodetic(double *restrict lat, double *restrict lon, double *restrict height,
+        const double *restrict x, const double *restrict y, const double *restrict z,
+        size_t count)
+{
+    // Heikkinen's closed-form solution.
+    const double a2 = WGS84_A * WGS84_A;
+    const double b2 = WGS84_B * WGS84_B;
+    const double e4 = WGS84_E2 * WGS84_E2;
+
+    for (size_t i = 0; i < count; i++) {
+        double z2 = z[i] * z[i];
+        double p2 = x[i] * x[i] + y[i] * y[i];
+        double p = sqrt(p2);
+        double F = 54.0 * b2 * z2;
+        double G = p2 + (1.0 - WGS84_E2) * z2 - WGS84_E2 * (a2 - b2);
+        double c = e4 * F * p2 / (G * G * G);
+        double s = cbrt(1.0 + c + sqrt(c * c + 2.0 * c));
+        double k = s + 1.0 + 1.0 / s;
+        double P = F / (3.0 * k * k * G * G);
+        double Q = sqrt(1.0 + 2.0 * e4 * P);
+        double r0 = -(P * WGS84_E2 * p) / (1.0 + Q)
+            + sqrt(0.5 * a2 * (1.0 + 1.0 / Q)
+                   - P * (1.0 - WGS84_E2) * z2 / (Q * (1.0 + Q))
+                   - 0.5 * P * p2);
+        double t = p - WGS84_E2 * r0;
+        double U = sqrt(t * t + z2);
+        double V = sqrt(t * t + (1.0 - WGS84_E2) * z2);
+        double z0 = b2 * z[i] / (WGS84_A * V);
+
+        height[i] = U * (1.0 - b2 / (WGS84_A * V));
+        lat[i] = atan2(z[i] + WGS84_EP2 * z0, p) * RAD2DEG;
+        lon[i] = atan2(y[i], x[i]) * RAD2DEG;
+    }
+}
+
+void minmea_enu_frame_init(struct minmea_enu_frame *frame, double lat, double lon, double height)
+{
+    minmea_geodetic_to_ecef(&frame->x0, &frame->y0, &frame->z0, &lat, &lon, &height, 1);
+    frame->sin_lat = sin(lat * DEG2RAD);
+    frame->cos_lat = cos(lat * DEG2RAD);
+    frame->sin_lon = sin(lon * DEG2RAD);
+    frame->cos_lon = cos(lon * DEG2RAD);
+}
+
+void minmea_ecef_to_enu(double *restrict east, double *restrict north, double *restrict up,
+        const double *restrict x, const double *restrict y, const double *restrict z, size_t count,
+        const struct minmea_enu_frame *frame)
+{
+    const struct minmea_enu_frame f = *frame;
+
+    for (size_t i = 0; i < count; i++) {
+        double dx = x[i] - f.x0;
+        double dy = y[i] - f.y0;
+        double dz = z[i] - f.z0;
+        east[i] = -f.sin_lon * dx + f.cos_lon * dy;
+        north[i] = -f.sin_lat * f.cos_lon * dx - f.sin_lat * f.sin_lon * dy + f.cos_lat * dz;
+        up[i] = f.cos_lat * f.cos_lon * dx + f.cos_lat * f.sin_lon * dy + f.sin_lat * dz;
+    }
+}
+
+void minmea_enu_to_ecef(double *restrict x, double *restrict y, double *restrict z,
+        const double *restrict east, const double *restrict north, const double *restrict up, size_t count,
+        const struct minmea_enu_frame *frame)
+{
+    const struct minmea_enu_frame f = *frame;
+
+    for (size_t i = 0; i < count; i++) {
+        x[i] = f.x0 - f.sin_lon * east[i] - f.sin_lat * f.cos_lon * north[i] + f.cos_lat * f.cos_lon * up[i];
+        y[i] = f.y0 + f.cos_lon * east[i] - f.sin_lat * f.sin_lon * north[i] + f.cos_lat * f.sin_lon * up[i];
+        z[i] = f.z0 + f.cos_lat * north[i] + f.sin_lat * up[i];
+    }
+}
+
+static inline double haversine(double lat1, double lon1, double lat2, double lon2)
+{
+    double phi1 = lat1 * DEG2RAD, phi2 = lat2 * DEG2RAD;
+    double s_phi = sin(0.5 * (phi2 - phi1));
+    double s_lambda = sin(0.5 * (lon2 - lon1) * DEG2RAD);
+    double h = s_phi * s_phi + cos(phi1) * cos(phi2) * s_lambda * s_lambda;
+    // Rounding can push h slightly above one for antipodal points.
+    h = h < 1.0 ? h : 1.0;
+    return 2.0 * EARTH_RADIUS * asin(sqrt(h));
+}
+
+void minmea_haversine(double *restrict distance,
+        const double *restrict lat1, const double *restrict lon1,
+        const double *restrict lat2, const double *restrict lon2, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+        distance[i] = haversine(lat1[i], lon1[i], lat2[i], lon2[i]);
+}
+
+void minmea_haversine_to(double *restrict distance,
+        const double *restrict lat, const double *restrict lon, size_t count,
+        double lat0, double lon0)
+{
+    for (size_t i = 0; i < count; i++)
+        distance[i] = haversine(lat[i], lon[i], lat0, lon0);
+}
+
+static inline double lon_delta(double d)
+{
+    // Wrap a difference of two longitudes in [-180, 180] to the short way round.
+    d -= d > 180.0 ? 360.0 : 0.0;
+    d += d < -180.0 ? 360.0 : 0.0;
+    return d;
+}
+
+void minmea_track_distance(double *restrict distance,
+        const double *restrict lat, const double *restrict lon, size_t count,
+        const double *restrict track_lat, const double *restrict track_lon, size_t track_count)
+{
+    const double ky = DEG2RAD * EARTH_RADIUS;
+
+    if (track_count == 0) {
+        for (size_t i = 0; i < count; i++)
+            distance[i] = NAN;
+        return;
+    }
+
+    // Points are taken in blocks and the track is walked once per block, so
+    // the inner loops run across points with no loop-carried state.
+    for (size_t start = 0; start < count; start += GEO_BLOCK) {
+        size_t n = count - start < GEO_BLOCK ? count - start : GEO_BLOCK;
+        const double *restrict la = lat + start;
+        const double *restrict lo = lon + start;
+        double *restrict best = distance + start;
+        double kx[GEO_BLOCK], ax[GEO_BLOCK], ay[GEO_BLOCK];
+
+        // Equirectangular projection centered on each query point.
+        for (size_t i = 0; i < n; i++) {
+            kx[i] = cos(la[i] * DEG2RAD) * ky;
+            ax[i] = lon_delta(track_lon[0] - lo[i]) * kx[i];
+            ay[i] = (track_lat[0] - la[i]) * ky;
+            best[i] = ax[i] * ax[i] + ay[i] * ay[i];
+        }
+
+        for (size_t j = 1; j < track_count; j++) {
+            for (size_t i = 0; i < n; i++) {
+                double bx = lon_delta(track_lon[j] - lo[i]) * kx[i];
+                double by = (track_lat[j] - la[i]) * ky;
+                double dx = bx - ax[i], dy = by - ay[i];
+                double len2 = dx * dx + dy * dy;
+                // Degenerate segments project onto their start point.
+                double t = len2 > 0.0 ? -(ax[i] * dx + ay[i] * dy) / len2 : 0.0;
+                t = t > 0.0 ? t : 0.0;
+                t = t < 1.0 ? t : 1.0;
+                double px = ax[i] + t * dx, py = ay[i] + t * dy;
+                double d2 = px * px + py * py;
+                double b = best[i];
+                best[i] = d2 < b ? d2 : b;
+                ax[i] = bx;
+                ay[i] = by;
+            }
+        }
+
+        for (size_t i = 0; i < n; i++)
+            best[i] = sqrt(best[i]);
+    }
+}
+
+/* vim: set ts=4 sw=4 et: */
@@ -0,0 +1,116 @@
+/**
+ * @file nmea_geo.h
+ * @brief Batch WGS-84 geodesy kernels over parsed fixes.
+ * @author wwk (1162431386@qq.com)
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2024  by  xxx
+ *
+ * @par 修改日志:
+ * <table>
+ * <tr><th>Date       <th>Version <th>Author  <th>Description
+ * <tr><td>2026-10-19     <td>1.0     <td>wwk   <td>新建
+ * </table>
+ */
+
+#ifndef MINMEA_GEO_H
+#define MINMEA_GEO_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+#include "nmea.h"
+
+/*
+ * All kernels work on structure-of-arrays inputs: latitudes and longitudes
+ * in degrees, heights and coordinates in meters. The loops run over
+ * non-aliasing arrays without loop-carried state. With -O3 the ENU
+ * conversions vectorize; the others also need -fno-math-errno
+ * -fno-trapping-math (so their selects can be if-converted) and, on x86-64,
+ * glibc 2.35 or later for the libmvec variants of sin, cos, asin, atan2 and
+ * cbrt. Define MINMEA_GEO_NO_LIBMVEC to keep those calls scalar.
+ */
+
+/**
+ * Local east-north-up frame anchored at a geodetic reference point.
+ */
+struct minmea_enu_frame {
+    double x0, y0, z0;
+    double sin_lat, cos_lat;
+    double sin_lon, cos_lon;
+};
+
+/**
+ * Gather GGA fixes into arrays. Heights are ellipsoidal (altitude above the
+ * geoid plus geoid separation). Unknown values become NaN.
+ */
+void minmea_geo_from_gga(double *lat, double *lon, double *height,
+        const struct minmea_sentence_gga *frames, size_t count);
+
+/**
+ * Geodetic to earth-centered, earth-fixed coordinates.
+ */
+void minmea_geodetic_to_ecef(double *x, double *y, double *z,
+        const double *lat, const double *lon, const double *height, size_t count);
+
+/**
+ * Earth-centered, earth-fixed to geodetic coordinates (closed form, no
+ * iteration).
+ */
+void minmea_ecef_to_geodetic(double *lat, double *lon, double *height,
+        const double *x, const double *y, const double *z, size_t count);
+
+/**
+ * Set up a local frame at the given reference point.
+ */
+void minmea_enu_frame_init(struct minmea_enu_frame *frame, double lat, double lon, double height);
+
+/**
+ * Earth-centered, earth-fixed to local east-north-up coordinates.
+ */
+void minmea_ecef_to_enu(double *east, double *north, double *up,
+        const double *x, const double *y, const double *z, size_t count,
+        const struct minmea_enu_frame *frame);
+
+/**
+ * Local east-north-up to earth-centered, earth-fixed coordinates.
+ */
+void minmea_enu_to_ecef(double *x, double *y, double *z,
+        const double *east, const double *north, const double *up, size_t count,
+        const struct minmea_enu_frame *frame);
+
+/**
+ * Great-circle (haversine) distance between pairs of points.
+ */
+void minmea_haversine(double *distance,
+        const double *lat1, const double *lon1,
+        const double *lat2, const double *lon2, size_t count);
+
+/**
+ * Great-circle (haversine) distance from every point to a single point.
+ */
+void minmea_haversine_to(double *distance,
+        const double *lat, const double *lon, size_t count,
+        double lat0, double lon0);
+
+/**
+ * Shortest distance from every point to a polyline track, measured in a
+ * local tangent plane at each point. Accurate for tracks within a few tens
+ * of kilometers of the point, which covers geofencing and track smoothing.
+ * Longitudes are expected in [-180, 180].
+ */
+void minmea_track_distance(double *distance,
+        const double *lat, const double *lon, size_t count,
+        const double *track_lat, const double *track_lon, size_t track_count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MINMEA_GEO_H */
+
+/* vim: set ts=4 sw=4 et: */
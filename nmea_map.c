@@ -0,0 +1,69 @@
+/**
+ * @file nmea_map.c
+ * @brief Read-only mappings of log files.
+ * @author wwk (1162431386@qq.com)
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2024  by  xxx
+ *
+ * @par 修改日志:
+ * <table>
+ * <tr><th>Date       <th>Version <th>Author  <th>Description
+ * <tr><td>2026-10-19     <td>1.0     <td>wwk   <td>新建
+ * </table>
+ */
+#include "nmea_map.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+int minmea_map_open(struct minmea_map *map, const char *path)
+{
+    map->data = NULL;
+    map->size = 0;
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+        return -1;
+
+    struct stat st;
+    if (fstat(fd, &st) == -1) {
+        close(fd);
+        return -1;
+    }
+
+    map->dev = st.st_dev;
+    map->ino = st.st_ino;
+    map->mtime_ns = (int_least64_t) st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+
+    if (st.st_size > 0) {
+        void *data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            int saved = errno;
+            close(fd);
+            errno = saved;
+            return -1;
+        }
+        madvise(data, st.st_size, MADV_SEQUENTIAL);
+        map->data = data;
+        map->size = st.st_size;
+    }
+
+    // The mapping outlives the descriptor.
+    close(fd);
+    return 0;
+}
+
+void minmea_map_close(struct minmea_map *map)
+{
+    if (map->data)
+        munmap((void *) map->data, map->size);
+    map->data = NULL;
+    map->size = 0;
+}
+
+/* vim: set ts=4 sw=4 et: */
@@ -0,0 +1,53 @@
+/**
+ * @file nmea_map.h
+ * @brief Read-only mappings of log files.
+ * @author wwk (1162431386@qq.com)
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2024  by  xxx
+ *
+ * @par 修改日志:
+ * <table>
+ * <tr><th>Date       <th>Version <th>Author  <th>Description
+ * <tr><td>2026-10-19     <td>1.0     <td>wwk   <td>新建
+ * </table>
+ */
+
+#ifndef MINMEA_MAP_H
+#define MINMEA_MAP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+/**
+ * A whole file mapped for sequential reading, with the identity it had when
+ * it was mapped. data is NULL for an empty file.
+ */
+struct minmea_map {
+    const char *data;
+    size_t size;
+    dev_t dev;
+    ino_t ino;
+    int_least64_t mtime_ns;
+};
+
+/**
+ * Map a file. Returns 0 on success, -1 on error (errno is set).
+ */
+int minmea_map_open(struct minmea_map *map, const char *path);
+
+void minmea_map_close(struct minmea_map *map);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MINMEA_MAP_H */
+
+/* vim: set ts=4 sw=4 et: */
@@ -0,0 +1,290 @@
+/**
+ * @file nmea_merge.c
+ * @brief Time-ordered merge of several NMEA streams.
+ * @author wwk (1162431386@qq.com)
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2024  by  xxx
+ *
+ * @par 修改日志:
+ * <table>
+ * <tr><th>Date       <th>Version <th>Author  <th>Description
+ * <tr><td>2026-10-19     <td>1.0     <td>wwk   <td>新建
+ * </table>
+ */
+#include "nmea_merge.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define DAY_US (INT64_C(86400) * 1000000)
+// Room for the longest sentence, CR, LF and the terminating NUL.
+#define LINE_SIZE (MINMEA_MAX_LONG_SENTENCE_LENGTH + 3)
+
+struct merge_entry {
+    char *line;
+    uint64_t seq;
+    int_least64_t tod;
+    int_least32_t day;
+    // Merge order, fixed when the entry is buffered or dated.
+    int_least64_t key;
+};
+
+struct minmea_merge_input {
+    FILE *fp;
+    struct merge_entry *entries;
+    size_t count;
+    uint64_t seq;
+    int_least64_t last_tod;
+    int_least32_t day;
+    bool eof;
+    // Earliest buffered entry, valid while the input is on the heap.
+    size_t min;
+    int_least64_t min_key;
+};
+
+static int_least64_t entry_key(const struct minmea_merge *merge, const struct merge_entry *entry)
+{
+    if (entry->day != -1)
+        return (int_least64_t) entry->day * DAY_US + entry->tod;
+    if (merge->reference_us == -1)
+        return entry->tod;
+
+    // Not dated yet; pick the day that puts it closest to the latest dated
+    // time stamp seen on any input.
+    int_least64_t base = merge->reference_us / DAY_US * DAY_US + entry->tod;
+    int_least64_t best = base;
+    if (llabs(base - DAY_US - merge->reference_us) < llabs(best - merge->reference_us))
+        best = base - DAY_US;
+    if (llabs(base + DAY_US - merge->reference_us) < llabs(best - merge->reference_us))
+        best = base + DAY_US;
+    return best;
+}
+
+/**
+ * Read the next sentence of an input into a free buffer entry.
+ */
+static bool input_read(struct minmea_merge *merge, struct minmea_merge_input *in)
+{
+    struct merge_entry *entry = &in->entries[in->count];
+
+    while (!in->eof) {
+        if (!fgets(entry->line, LINE_SIZE, in->fp)) {
+            in->eof = true;
+            break;
+        }
+
+        size_t length = strlen(entry->line);
+        if (length == LINE_SIZE - 1 && entry->line[length - 1] != '\n') {
+            // Overlong line; drop the rest of it.
+            int c;
+            while ((c = getc(in->fp)) != EOF && c != '\n')
+                ;
+            continue;
+        }
+        while (length && (entry->line[length - 1] == '\n' || entry->line[length - 1] == '\r'))
+            entry->line[--length] = '\0';
+        if (length > MINMEA_MAX_LONG_SENTENCE_LENGTH)
+            continue;
+        if (entry->line[0] != '$' && entry->line[0] != '!')
+            continue;
+
+        struct minmea_date date;
+        struct minmea_time time_;
+        int_least32_t day = -1;
+
+        if (minmea_sentence_time(&date, &time_, entry->line)) {
+            int_least64_t tod = minmea_time_us(&time_);
+            day = minmea_daynumber(&date);
+
+            if (day != -1) {
+                // Date the entries still waiting for one.
+                for (size_t i = 0; i < in->count; i++) {
+                    struct merge_entry *waiting = &in->entries[i];
+                    if (waiting->day == -1) {
+                        waiting->day = day - (waiting->tod > tod + DAY_US / 2);
+                        waiting->key = entry_key(merge, waiting);
+                    }
+                }
+                in->day = day;
+            } else if (in->day != -1) {
+                if (in->last_tod != -1 && tod < in->last_tod - DAY_US / 2)
+                    in->day++;
+                day = in->day;
+            }
+            in->last_tod = tod;
+        } else {
+            day = in->day;
+        }
+
+        entry->tod = in->last_tod == -1 ? 0 : in->last_tod;
+        entry->day = day;
+        if (day != -1) {
+            int_least64_t key = (int_least64_t) day * DAY_US + entry->tod;
+            if (key > merge->reference_us)
+                merge->reference_us = key;
+        }
+        // Computed once: reference_us moves on while inputs sit on the heap.
+        entry->key = entry_key(merge, entry);
+        entry->seq = in->seq++;
+        in->count++;
+        return true;
+    }
+
+    return false;
+}
+
+static void input_fill(struct minmea_merge *merge, struct minmea_merge_input *in)
+{
+    while (in->count < merge->depth && input_read(merge, in))
+        ;
+}
+
+static void input_update_min(struct minmea_merge_input *in)
+{
+    size_t best = 0;
+    int_least64_t best_key = in->entries[0].key;
+
+    for (size_t i = 1; i < in->count; i++) {
+        int_least64_t key = in->entries[i].key;
+        if (key < best_key || (key == best_key && in->entries[i].seq < in->entries[best].seq)) {
+            best = i;
+            best_key = key;
+        }
+    }
+
+    in->min = best;
+    in->min_key = best_key;
+}
+
+static bool heap_less(const struct minmea_merge *merge, size_t a, size_t b)
+{
+    const struct minmea_merge_input *ia = &merge->inputs[a], *ib = &merge->inputs[b];
+    if (ia->min_key != ib->min_key)
+        return ia->min_key < ib->min_key;
+    return a < b;
+}
+
+static void heap_push(struct minmea_merge *merge, size_t input)
+{
+    size_t i = merge->heap_size++;
+    while (i > 0) {
+        size_t parent = (i - 1) / 2;
+        if (!heap_less(merge, input, merge->heap[parent]))
+            break;
+        merge->heap[i] = merge->heap[parent];
+        i = parent;
+    }
+    merge->heap[i] = input;
+}
+
+static size_t heap_pop(struct minmea_merge *merge)
+{
+    size_t top = merge->heap[0];
+    size_t last = merge->heap[--merge->heap_size];
+    size_t i = 0;
+
+    for (;;) {
+        size_t child = 2 * i + 1;
+        if (child >= merge->heap_size)
+            break;
+        if (child + 1 < merge->heap_size && heap_less(merge, merge->heap[child + 1], merge->heap[child]))
+            child++;
+        if (!heap_less(merge, merge->heap[child], last))
+            break;
+        merge->heap[i] = merge->heap[child];
+        i = child;
+    }
+    if (merge->heap_size)
+        merge->heap[i] = last;
+
+    return top;
+}
+
+int minmea_merge_init(struct minmea_merge *merge, FILE *const *inputs, size_t count, size_t depth)
+{
+    memset(merge, 0, sizeof(*merge));
+    if (depth == 0)
+        depth = 1;
+
+    merge->inputs = calloc(count ? count : 1, sizeof(*merge->inputs));
+    merge->heap = calloc(count ? count : 1, sizeof(*merge->heap));
+    merge->storage = malloc(count * depth * (sizeof(struct merge_entry) + LINE_SIZE) + 1);
+    if (!merge->inputs || !merge->heap || !merge->storage) {
+        minmea_merge_free(merge);
+        return -1;
+    }
+
+    merge->input_count = count;
+    merge->depth = depth;
+    merge->reference_us = -1;
+
+    struct merge_entry *entries = (struct merge_entry *) merge->storage;
+    char *lines = merge->storage + count * depth * sizeof(struct merge_entry);
+
+    for (size_t i = 0; i < count; i++) {
+        struct minmea_merge_input *in = &merge->inputs[i];
+        in->fp = inputs[i];
+        in->entries = entries + i * depth;
+        for (size_t j = 0; j < depth; j++)
+            in->entries[j].line = lines + (i * depth + j) * LINE_SIZE;
+        in->last_tod = -1;
+        in->day = -1;
+    }
+
+    // Prime every buffer before ordering, so early dates reach all inputs.
+    for (size_t i = 0; i < count; i++)
+        input_fill(merge, &merge->inputs[i]);
+    for (size_t i = 0; i < count; i++) {
+        if (merge->inputs[i].count) {
+            input_update_min(&merge->inputs[i]);
+            heap_push(merge, i);
+        }
+    }
+
+    return 0;
+}
+
+void minmea_merge_free(struct minmea_merge *merge)
+{
+    free(merge->inputs);
+    free(merge->heap);
+    free(merge->storage);
+    merge->inputs = NULL;
+    merge->heap = NULL;
+    merge->storage = NULL;
+    merge->input_count = 0;
+    merge->heap_size = 0;
+}
+
+const char *minmea_merge_next(struct minmea_merge *merge, size_t *input, int_least64_t *timestamp_us)
+{
+    if (merge->heap_size == 0)
+        return NULL;
+
+    size_t index = heap_pop(merge);
+    struct minmea_merge_input *in = &merge->inputs[index];
+    struct merge_entry *entry = &in->entries[in->min];
+
+    if (input)
+        *input = index;
+    if (timestamp_us)
+        *timestamp_us = in->min_key;
+    strcpy(merge->line, entry->line);
+
+    // Move the last entry into the freed place, keeping its buffer.
+    char *freed = entry->line;
+    *entry = in->entries[--in->count];
+    in->entries[in->count].line = freed;
+
+    input_fill(merge, in);
+    if (in->count) {
+        input_update_min(in);
+        heap_push(merge, index);
+    }
+
+    return merge->line;
+}
+
+/* vim: set ts=4 sw=4 et: */
@@ -0,0 +1,75 @@
+/**
+ * @file nmea_merge.h
+ * @brief Time-ordered merge of several NMEA streams.
+ * @author wwk (1162431386@qq.com)
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2024  by  xxx
+ *
+ * @par 修改日志:
+ * <table>
+ * <tr><th>Date       <th>Version <th>Author  <th>Description
+ * <tr><td>2026-10-19     <td>1.0     <td>wwk   <td>新建
+ * </table>
+ */
+
+#ifndef MINMEA_MERGE_H
+#define MINMEA_MERGE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdio.h>
+
+#include "nmea.h"
+
+struct minmea_merge_input;
+
+/**
+ * Streaming k-way merge. Each input keeps a reorder buffer of depth
+ * sentences to absorb local disorder; the inputs are merged through a
+ * min-heap on their earliest buffered time stamp. Memory use is fixed at
+ * initialization, independent of the input sizes.
+ *
+ * Date-less sentences (GGA, GLL, ...) take the date of the last RMC/ZDA of
+ * their input, rolling over at midnight; sentences without a time stamp
+ * (GSA, GSV, ...) stay with the preceding time stamp of their input.
+ */
+struct minmea_merge {
+    struct minmea_merge_input *inputs;
+    size_t input_count;
+    size_t depth;
+    size_t *heap;
+    size_t heap_size;
+    int_least64_t reference_us;
+    char *storage;
+    char line[MINMEA_MAX_LONG_SENTENCE_LENGTH + 1];
+};
+
+/**
+ * Set up a merge over count open streams with the given reorder depth.
+ * Returns 0 on success, -1 on allocation failure.
+ */
+int minmea_merge_init(struct minmea_merge *merge, FILE *const *inputs, size_t count, size_t depth);
+
+void minmea_merge_free(struct minmea_merge *merge);
+
+/**
+ * Next sentence in time order (NUL-terminated, without line ending), or
+ * NULL once all inputs are exhausted. Optionally reports the index of the
+ * input it came from and its time stamp in microseconds since 1970 (since
+ * day zero if no input carried a date). The sentence stays valid until the
+ * next call.
+ */
+const char *minmea_merge_next(struct minmea_merge *merge, size_t *input, int_least64_t *timestamp_us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MINMEA_MERGE_H */
+
+/* vim: set ts=4 sw=4 et: */
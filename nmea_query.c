@@ -0,0 +1,433 @@
+/**
+ * @file nmea_query.c
+ * @brief Spatial and temporal queries over indexed GGA log archives.
+ * @author wwk (1162431386@qq.com)
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2024  by  xxx
+ *
+ * @par 修改日志:
+ * <table>
+ * <tr><th>Date       <th>Version <th>Author  <th>Description
+ * <tr><td>2026-10-19     <td>1.0     <td>wwk   <td>新建
+ * </table>
+ */
+#include "nmea_query.h"
+
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "nmea_map.h"
+
+#define INDEX_MAGIC   0x49514e4du   // "MNQI"
+#define INDEX_VERSION 2
+
+struct index_header {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t file_size;
+    uint64_t file_ino;
+    uint64_t count;
+};
+
+/**
+ * Copy the line starting at offset into buf as a NUL-terminated sentence.
+ * Returns the offset of the following line; buf is empty for lines that
+ * can't be GGA sentences.
+ */
+static size_t next_line(const char *data, size_t offset, size_t end, char *buf)
+{
+    const char *start = data + offset;
+    const char *nl = memchr(start, '\n', end - offset);
+    size_t length = nl ? (size_t) (nl - start) : end - offset;
+    size_t next = offset + length + (nl ? 1 : 0);
+
+    if (length && start[length - 1] == '\r')
+        length--;
+
+    buf[0] = '\0';
+    if (length < 7 || length > MINMEA_MAX_LONG_SENTENCE_LENGTH)
+        return next;
+    if (start[0] != '$' || memcmp(start + 3, "GGA,", 4))
+        return next;
+
+    memcpy(buf, start, length);
+    buf[length] = '\0';
+    return next;
+}
+
+static int grid_cell(int32_t v, int32_t min, int32_t max)
+{
+    return (int) (((int_least64_t) v - min) * 8 / ((int_least64_t) max - min + 1));
+}
+
+struct build_state {
+    int32_t *points;
+    size_t capacity;
+};
+
+static int summarize_block(struct minmea_block_summary *block, const char *data, struct build_state *state)
+{
+    char line[MINMEA_MAX_LONG_SENTENCE_LENGTH + 1];
+    size_t offset = block->offset;
+    size_t end = block->offset + block->length;
+
+    block->fixes = 0;
+    block->time_min_us = INT64_MAX;
+    block->time_max_us = -1;
+    block->lat_min = block->lon_min = INT32_MAX;
+    block->lat_max = block->lon_max = INT32_MIN;
+    block->fix_min = UINT8_MAX;
+    block->fix_max = 0;
+    block->grid = 0;
+
+    while (offset < end) {
+        offset = next_line(data, offset, end, line);
+        if (!line[0])
+            continue;
+
+        struct minmea_sentence_gga frame;
+        if (!minmea_check(line, false) || !minmea_parse_gga(&frame, line))
+            continue;
+
+        double lat = minmea_tocoord_double(&frame.latitude);
+        double lon = minmea_tocoord_double(&frame.longitude);
+        if (isnan(lat) || isnan(lon))
+            continue;
+
+        int32_t lat7 = (int32_t) lround(lat * 1e7);
+        int32_t lon7 = (int32_t) lround(lon * 1e7);
+        int_least64_t t = minmea_time_us(&frame.time);
+        uint8_t q = frame.fix_quality < 0 ? 0 : frame.fix_quality > UINT8_MAX ? UINT8_MAX : frame.fix_quality;
+
+        if (2 * (block->fixes + 1) > state->capacity) {
+            size_t capacity = state->capacity ? state->capacity * 2 : 1024;
+            int32_t *points = realloc(state->points, capacity * sizeof(*points));
+            if (!points)
+                return -1;
+            state->points = points;
+            state->capacity = capacity;
+        }
+        state->points[2 * block->fixes] = lat7;
+        state->points[2 * block->fixes + 1] = lon7;
+        block->fixes++;
+
+        if (lat7 < block->lat_min) block->lat_min = lat7;
+        if (lat7 > block->lat_max) block->lat_max = lat7;
+        if (lon7 < block->lon_min) block->lon_min = lon7;
+        if (lon7 > block->lon_max) block->lon_max = lon7;
+        if (q < block->fix_min) block->fix_min = q;
+        if (q > block->fix_max) block->fix_max = q;
+        if (t != -1 && t < block->time_min_us) block->time_min_us = t;
+        if (t > block->time_max_us) block->time_max_us = t;
+    }
+
+    for (uint32_t i = 0; i < block->fixes; i++) {
+        int y = grid_cell(state->points[2 * i], block->lat_min, block->lat_max);
+        int x = grid_cell(state->points[2 * i + 1], block->lon_min, block->lon_max);
+        block->grid |= UINT64_C(1) << (y * 8 + x);
+    }
+
+    return 0;
+}
+
+int minmea_index_build(struct minmea_index *index, const char *path, size_t block_size)
+{
+    struct minmea_map map;
+
+    memset(index, 0, sizeof(*index));
+    if (block_size == 0)
+        block_size = MINMEA_QUERY_BLOCK_SIZE;
+    if (minmea_map_open(&map, path) == -1)
+        return -1;
+
+    const char *data = map.data;
+    size_t size = map.size;
+
+    struct build_state state = { NULL, 0 };
+    size_t capacity = size / block_size + 1;
+    int result = -1;
+
+    index->blocks = calloc(capacity, sizeof(*index->blocks));
+    if (!index->blocks)
+        goto out;
+
+    size_t offset = 0;
+    while (offset < size) {
+        // Blocks end on a line boundary at or after block_size bytes.
+        size_t end = offset + block_size;
+        if (end >= size) {
+            end = size;
+        } else {
+            const char *nl = memchr(data + end, '\n', size - end);
+            end = nl ? (size_t) (nl - data) + 1 : size;
+        }
+
+        if (index->count == capacity) {
+            struct minmea_block_summary *blocks = realloc(index->blocks, 2 * capacity * sizeof(*blocks));
+            if (!blocks)
+                goto out;
+            index->blocks = blocks;
+            capacity *= 2;
+        }
+
+        struct minmea_block_summary *block = &index->blocks[index->count++];
+        block->offset = offset;
+        block->length = end - offset;
+        if (summarize_block(block, data, &state) == -1)
+            goto out;
+
+        offset = end;
+    }
+
+    index->file_size = size;
+    index->file_ino = map.ino;
+    result = 0;
+
+out:
+    free(state.points);
+    minmea_map_close(&map);
+    if (result == -1) {
+        int saved = errno;
+        minmea_index_free(index);
+        errno = saved;
+    }
+    return result;
+}
+
+int minmea_index_save(const struct minmea_index *index, const char *path)
+{
+    FILE *fp = fopen(path, "wb");
+    if (!fp)
+        return -1;
+
+    struct index_header header = {
+        .magic = INDEX_MAGIC,
+        .version = INDEX_VERSION,
+        .file_size = index->file_size,
+        .file_ino = index->file_ino,
+        .count = index->count,
+    };
+
+    bool ok = fwrite(&header, sizeof(header), 1, fp) == 1 &&
+              fwrite(index->blocks, sizeof(*index->blocks), index->count, fp) == index->count;
+    if (fclose(fp) != 0)
+        ok = false;
+
+    return ok ? 0 : -1;
+}
+
+int minmea_index_load(struct minmea_index *index, const char *path)
+{
+    memset(index, 0, sizeof(*index));
+
+    FILE *fp = fopen(path, "rb");
+    if (!fp)
+        return -1;
+
+    struct index_header header;
+    if (fread(&header, sizeof(header), 1, fp) != 1 ||
+        header.magic != INDEX_MAGIC || header.version != INDEX_VERSION) {
+        fclose(fp);
+        errno = EINVAL;
+        return -1;
+    }
+
+    index->blocks = calloc(header.count ? header.count : 1, sizeof(*index->blocks));
+    if (!index->blocks) {
+        fclose(fp);
+        return -1;
+    }
+    if (fread(index->blocks, sizeof(*index->blocks), header.count, fp) != header.count) {
+        fclose(fp);
+        minmea_index_free(index);
+        errno = EINVAL;
+        return -1;
+    }
+
+    fclose(fp);
+
+    // Block ranges are used as offsets into the mapped log.
+    for (uint64_t i = 0; i < header.count; i++) {
+        const struct minmea_block_summary *block = &index->blocks[i];
+        if (block->offset > header.file_size || block->length > header.file_size - block->offset) {
+            minmea_index_free(index);
+            errno = EINVAL;
+            return -1;
+        }
+    }
+
+    index->count = header.count;
+    index->file_size = header.file_size;
+    index->file_ino = header.file_ino;
+    return 0;
+}
+
+void minmea_index_free(struct minmea_index *index)
+{
+    free(index->blocks);
+    index->blocks = NULL;
+    index->count = 0;
+    index->file_size = 0;
+    index->file_ino = 0;
+}
+
+void minmea_query_init(struct minmea_query *query)
+{
+    query->time_min_us = -1;
+    query->time_max_us = -1;
+    query->has_box = false;
+    query->lat_min = query->lat_max = 0;
+    query->lon_min = query->lon_max = 0;
+    query->min_fix_quality = -1;
+}
+
+static bool time_match(const struct minmea_query *query, int_least64_t lo, int_least64_t hi)
+{
+    int_least64_t qmin = query->time_min_us, qmax = query->time_max_us;
+
+    if (qmin == -1 && qmax == -1)
+        return true;
+    if (qmin == -1)
+        return lo <= qmax;
+    if (qmax == -1)
+        return hi >= qmin;
+    if (qmin <= qmax)
+        return hi >= qmin && lo <= qmax;
+    // Range wraps around midnight.
+    return hi >= qmin || lo <= qmax;
+}
+
+static bool block_match(const struct minmea_query *query, const struct minmea_block_summary *block)
+{
+    if (block->fixes == 0)
+        return false;
+    if (query->min_fix_quality > block->fix_max)
+        return false;
+    if (!time_match(query, block->time_min_us, block->time_max_us))
+        return false;
+    if (!query->has_box)
+        return true;
+
+    double lat_lo = floor(query->lat_min * 1e7), lat_hi = ceil(query->lat_max * 1e7);
+    double lon_lo = floor(query->lon_min * 1e7), lon_hi = ceil(query->lon_max * 1e7);
+    if (lat_hi < block->lat_min || lat_lo > block->lat_max ||
+        lon_hi < block->lon_min || lon_lo > block->lon_max)
+        return false;
+
+    // Intersect with the occupied grid cells.
+    int32_t y0 = lat_lo > block->lat_min ? (int32_t) lat_lo : block->lat_min;
+    int32_t y1 = lat_hi < block->lat_max ? (int32_t) lat_hi : block->lat_max;
+    int32_t x0 = lon_lo > block->lon_min ? (int32_t) lon_lo : block->lon_min;
+    int32_t x1 = lon_hi < block->lon_max ? (int32_t) lon_hi : block->lon_max;
+    int cx0 = grid_cell(x0, block->lon_min, block->lon_max);
+    int cx1 = grid_cell(x1, block->lon_min, block->lon_max);
+    int cy0 = grid_cell(y0, block->lat_min, block->lat_max);
+    int cy1 = grid_cell(y1, block->lat_min, block->lat_max);
+
+    uint64_t row = ((UINT64_C(1) << (cx1 - cx0 + 1)) - 1) << cx0;
+    uint64_t mask = 0;
+    for (int y = cy0; y <= cy1; y++)
+        mask |= row << (y * 8);
+
+    return (block->grid & mask) != 0;
+}
+
+static bool fix_match(const struct minmea_query *query, const struct minmea_sentence_gga *frame)
+{
+    if (frame->fix_quality < query->min_fix_quality)
+        return false;
+
+    int_least64_t t = minmea_time_us(&frame->time);
+    if ((query->time_min_us != -1 || query->time_max_us != -1) &&
+        (t == -1 || !time_match(query, t, t)))
+        return false;
+
+    double lat = minmea_tocoord_double(&frame->latitude);
+    double lon = minmea_tocoord_double(&frame->longitude);
+    if (isnan(lat) || isnan(lon))
+        return false;
+    if (query->has_box &&
+        (lat < query->lat_min || lat > query->lat_max ||
+         lon < query->lon_min || lon > query->lon_max))
+        return false;
+
+    return true;
+}
+
+/**
+ * Parse and filter one range of the log. Returns false if the callback
+ * asked to stop.
+ */
+static bool scan_range(const char *data, size_t offset, size_t end,
+        const struct minmea_query *query, minmea_query_cb callback, void *user,
+        struct minmea_query_stats *stats)
+{
+    char line[MINMEA_MAX_LONG_SENTENCE_LENGTH + 1];
+
+    while (offset < end) {
+        offset = next_line(data, offset, end, line);
+        if (!line[0])
+            continue;
+
+        struct minmea_sentence_gga frame;
+        stats->sentences_parsed++;
+        if (!minmea_check(line, false) || !minmea_parse_gga(&frame, line))
+            continue;
+        if (!fix_match(query, &frame))
+            continue;
+
+        stats->matches++;
+        if (callback && !callback(&frame, line, user))
+            return false;
+    }
+
+    return true;
+}
+
+long minmea_query_run(const struct minmea_index *index, const char *path,
+        const struct minmea_query *query, minmea_query_cb callback, void *user,
+        struct minmea_query_stats *stats)
+{
+    struct minmea_query_stats local;
+    struct minmea_map map;
+
+    if (!stats)
+        stats = &local;
+    memset(stats, 0, sizeof(*stats));
+
+    if (minmea_map_open(&map, path) == -1)
+        return -1;
+    if (map.size < index->file_size || map.ino != index->file_ino) {
+        // The log was truncated or replaced; the index no longer applies.
+        minmea_map_close(&map);
+        errno = ESTALE;
+        return -1;
+    }
+
+    const char *data = map.data;
+    size_t size = map.size;
+
+    bool more = true;
+    stats->blocks = index->count;
+    for (size_t i = 0; more && i < index->count; i++) {
+        const struct minmea_block_summary *block = &index->blocks[i];
+        if (!block_match(query, block))
+            continue;
+        stats->blocks_scanned++;
+        more = scan_range(data, block->offset, block->offset + block->length, query, callback, user, stats);
+    }
+
+    // Not yet indexed.
+    if (more && size > index->file_size)
+        scan_range(data, index->file_size, size, query, callback, user, stats);
+
+    minmea_map_close(&map);
+    return (long) stats->matches;
+}
+
+/* vim: set ts=4 sw=4 et: */
@@ -0,0 +1,119 @@
+/**
+ * @file nmea_query.h
+ * @brief Spatial and temporal queries over indexed GGA log archives.
+ * @author wwk (1162431386@qq.com)
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2024  by  xxx
+ *
+ * @par 修改日志:
+ * <table>
+ * <tr><th>Date       <th>Version <th>Author  <th>Description
+ * <tr><td>2026-10-19     <td>1.0     <td>wwk   <td>新建
+ * </table>
+ */
+
+#ifndef MINMEA_QUERY_H
+#define MINMEA_QUERY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+#include "nmea.h"
+
+// Default block size for minmea_index_build().
+#ifndef MINMEA_QUERY_BLOCK_SIZE
+#define MINMEA_QUERY_BLOCK_SIZE (64 * 1024)
+#endif
+
+/**
+ * Summary of the GGA fixes in one block of a log. Coordinates are in 1e-7
+ * degrees, times in microseconds since midnight. grid marks the occupied
+ * cells of an 8x8 grid laid over the block's bounding box.
+ */
+struct minmea_block_summary {
+    uint64_t offset;
+    uint32_t length;
+    uint32_t fixes;
+    int_least64_t time_min_us;
+    int_least64_t time_max_us;
+    int32_t lat_min, lat_max;
+    int32_t lon_min, lon_max;
+    uint8_t fix_min, fix_max;
+    uint64_t grid;
+};
+
+struct minmea_index {
+    struct minmea_block_summary *blocks;
+    size_t count;
+    uint64_t file_size;
+    uint64_t file_ino;
+};
+
+/**
+ * Query predicates. A time range with time_min_us > time_max_us wraps around
+ * midnight. Use minmea_query_init() to start from an unbounded query.
+ */
+struct minmea_query {
+    int_least64_t time_min_us, time_max_us;
+    bool has_box;
+    double lat_min, lat_max;
+    double lon_min, lon_max;
+    int min_fix_quality;
+};
+
+struct minmea_query_stats {
+    size_t blocks;
+    size_t blocks_scanned;
+    unsigned long sentences_parsed;
+    unsigned long matches;
+};
+
+/**
+ * Called for every matching fix. Return false to stop the query.
+ */
+typedef bool (*minmea_query_cb)(const struct minmea_sentence_gga *frame, const char *sentence, void *user);
+
+/**
+ * Scan a log once and build its block index. Returns 0 on success, -1 on
+ * error (errno is set).
+ */
+int minmea_index_build(struct minmea_index *index, const char *path, size_t block_size);
+
+/**
+ * Store or load an index. The file is in host byte order. Loading rejects
+ * indexes whose blocks lie outside the indexed size (errno EINVAL).
+ * Returns 0 on success, -1 on error (errno is set).
+ */
+int minmea_index_save(const struct minmea_index *index, const char *path);
+int minmea_index_load(struct minmea_index *index, const char *path);
+
+void minmea_index_free(struct minmea_index *index);
+
+/**
+ * Reset a query to match every fix.
+ */
+void minmea_query_init(struct minmea_query *query);
+
+/**
+ * Run a query against a log and its index. Blocks whose summaries cannot
+ * match are skipped without parsing; data appended to the log after the
+ * index was built is scanned in full. Returns the number of matches, or -1
+ * on error (errno is set; ESTALE if the log was truncated or is no longer
+ * the indexed file).
+ */
+long minmea_query_run(const struct minmea_index *index, const char *path,
+        const struct minmea_query *query, minmea_query_cb callback, void *user,
+        struct minmea_query_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MINMEA_QUERY_H */
+
+/* vim: set ts=4 sw=4 et: */
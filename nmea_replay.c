@@ -0,0 +1,206 @@
+/**
+ * @file nmea_replay.c
+ * @brief Rate-controlled replay of recorded NMEA logs.
+ * @author wwk (1162431386@qq.com)
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2024  by  xxx
+ *
+ * @par 修改日志:
+ * <table>
+ * <tr><th>Date       <th>Version <th>Author  <th>Description
+ * <tr><td>2026-10-19     <td>1.0     <td>wwk   <td>新建
+ * </table>
+ */
+#include "nmea_replay.h"
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+#define DAY_US (INT64_C(86400) * 1000000)
+
+int minmea_replay_open(struct minmea_replay *replay, const char *path, double speed)
+{
+    memset(replay, 0, sizeof(*replay));
+    replay->speed = speed;
+    replay->fd = -1;
+    replay->start_ns = -1;
+    replay->last_tod_us = -1;
+    replay->day = -1;
+
+    return minmea_map_open(&replay->map, path);
+}
+
+void minmea_replay_close(struct minmea_replay *replay)
+{
+    minmea_map_close(&replay->map);
+}
+
+void minmea_replay_output(struct minmea_replay *replay, minmea_replay_cb callback, void *user, int fd)
+{
+    replay->callback = callback;
+    replay->user = user;
+    replay->fd = fd;
+}
+
+int_least64_t minmea_replay_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int_least64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/**
+ * Load the next sentence from the mapping and advance the log timeline.
+ * Returns false at the end of the log.
+ */
+static bool replay_next_line(struct minmea_replay *replay)
+{
+    while (replay->offset < replay->map.size) {
+        const char *start = replay->map.data + replay->offset;
+        size_t left = replay->map.size - replay->offset;
+        const char *end = memchr(start, '\n', left);
+        size_t length = end ? (size_t) (end - start) : left;
+
+        replay->offset += end ? length + 1 : length;
+
+        if (length && start[length - 1] == '\r')
+            length--;
+        // Skip blank, overlong and non-sentence lines.
+        if (length == 0 || length > MINMEA_MAX_LONG_SENTENCE_LENGTH)
+            continue;
+        if (start[0] != '$' && start[0] != '!')
+            continue;
+
+        memcpy(replay->line, start, length);
+        replay->line[length] = '\0';
+        replay->line_length = length;
+
+        // Sentences failing their checksum do not move the timeline: one
+        // corrupted time field would otherwise jump it ahead for good.
+        struct minmea_date date;
+        struct minmea_time time_;
+        if (minmea_check(replay->line, false) && minmea_sentence_time(&date, &time_, replay->line)) {
+            int_least64_t tod = minmea_time_us(&time_);
+            int_least32_t day = minmea_daynumber(&date);
+
+            if (replay->last_tod_us != -1) {
+                int_least64_t delta = tod - replay->last_tod_us;
+                if (day != -1 && replay->day != -1) {
+                    delta += (int_least64_t) (day - replay->day) * DAY_US;
+                } else if (delta < -DAY_US / 2) {
+                    // Midnight passed on a date-less sentence.
+                    delta += DAY_US;
+                    if (replay->day != -1)
+                        replay->day++;
+                }
+                // Never step back in time.
+                if (delta > 0)
+                    replay->log_us += delta;
+            }
+            if (day != -1)
+                replay->day = day;
+            replay->last_tod_us = tod;
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+static void replay_deliver(struct minmea_replay *replay)
+{
+    if (replay->callback)
+        replay->callback(replay->line, replay->user);
+
+    if (replay->fd != -1) {
+        size_t length = replay->line_length;
+        replay->line[length] = '\r';
+        replay->line[length + 1] = '\n';
+        const char *p = replay->line;
+        size_t left = length + 2;
+        while (left) {
+            ssize_t n = write(replay->fd, p, left);
+            if (n == -1 && errno == EINTR)
+                continue;
+            // Datagram and tty consumers may drop; replay continues.
+            if (n <= 0)
+                break;
+            p += n;
+            left -= n;
+        }
+        replay->line[length] = '\0';
+    }
+
+    replay->sentences++;
+    replay->bytes += replay->line_length;
+}
+
+int_least64_t minmea_replay_poll(struct minmea_replay *replay, int_least64_t now_ns)
+{
+    if (replay->start_ns == -1)
+        replay->start_ns = now_ns;
+
+    for (int burst = 0;; burst++) {
+        if (!replay->pending) {
+            if (!replay_next_line(replay))
+                return -1;
+            replay->pending = true;
+        }
+
+        int_least64_t deadline = replay->start_ns;
+        if (replay->speed > 0)
+            deadline += (int_least64_t) (replay->log_us * 1000 / replay->speed);
+
+        // Yield after a burst so one fast replay can't starve the others.
+        if (deadline > now_ns || burst == MINMEA_REPLAY_BURST)
+            return deadline;
+
+        replay_deliver(replay);
+        replay->pending = false;
+
+        int_least64_t late = now_ns - deadline;
+        if (replay->speed > 0) {
+            replay->jitter_sum_ns += late;
+            if (late > replay->jitter_max_ns)
+                replay->jitter_max_ns = late;
+        }
+        replay->last_ns = now_ns;
+    }
+}
+
+int minmea_replay_run(struct minmea_replay *replay)
+{
+    for (;;) {
+        int_least64_t next = minmea_replay_poll(replay, minmea_replay_now());
+        if (next == -1)
+            return 0;
+
+        struct timespec ts = {
+            .tv_sec = next / 1000000000,
+            .tv_nsec = next % 1000000000,
+        };
+        int err;
+        while ((err = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL)) == EINTR)
+            ;
+        if (err) {
+            errno = err;
+            return -1;
+        }
+    }
+}
+
+void minmea_replay_stats(const struct minmea_replay *replay, struct minmea_replay_stats *stats)
+{
+    stats->sentences = replay->sentences;
+    stats->bytes = replay->bytes;
+    stats->elapsed_ns = replay->start_ns == -1 ? 0 : replay->last_ns - replay->start_ns;
+    stats->rate = stats->elapsed_ns > 0 ? replay->sentences * 1e9 / stats->elapsed_ns : 0;
+    stats->jitter_mean_ns = replay->sentences ? replay->jitter_sum_ns / (int_least64_t) replay->sentences : 0;
+    stats->jitter_max_ns = replay->jitter_max_ns;
+}
+
+/* vim: set ts=4 sw=4 et: */
@@ -0,0 +1,128 @@
+/**
+ * @file nmea_replay.h
+ * @brief Rate-controlled replay of recorded NMEA logs.
+ * @author wwk (1162431386@qq.com)
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2024  by  xxx
+ *
+ * @par 修改日志:
+ * <table>
+ * <tr><th>Date       <th>Version <th>Author  <th>Description
+ * <tr><td>2026-10-19     <td>1.0     <td>wwk   <td>新建
+ * </table>
+ */
+
+#ifndef MINMEA_REPLAY_H
+#define MINMEA_REPLAY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+#include "nmea.h"
+#include "nmea_map.h"
+
+// Most sentences delivered by one minmea_replay_poll() call.
+#ifndef MINMEA_REPLAY_BURST
+#define MINMEA_REPLAY_BURST 64
+#endif
+
+/**
+ * Called for every replayed sentence (NUL-terminated, without line ending).
+ */
+typedef void (*minmea_replay_cb)(const char *sentence, void *user);
+
+struct minmea_replay_stats {
+    unsigned long sentences;
+    unsigned long bytes;
+    int_least64_t elapsed_ns;
+    double rate;                    // sentences per second
+    int_least64_t jitter_mean_ns;   // mean delivery lateness
+    int_least64_t jitter_max_ns;    // worst delivery lateness
+};
+
+/**
+ * Replay state for a single log. The log is mapped read-only and the
+ * timeline is taken from the time stamps of sentences that do not fail their
+ * checksum (sentences without one still count); dates from RMC/ZDA are
+ * carried over to the date-less sentences in between.
+ */
+struct minmea_replay {
+    struct minmea_map map;
+    size_t offset;
+    double speed;
+    minmea_replay_cb callback;
+    void *user;
+    int fd;
+
+    int_least64_t start_ns;
+    int_least64_t log_us;
+    int_least64_t last_tod_us;
+    int_least32_t day;
+
+    unsigned long sentences;
+    unsigned long bytes;
+    int_least64_t jitter_sum_ns;
+    int_least64_t jitter_max_ns;
+    int_least64_t last_ns;
+
+    bool pending;
+    size_t line_length;
+    char line[MINMEA_MAX_LONG_SENTENCE_LENGTH + 3];
+};
+
+/**
+ * Map a log for replay. A speed of 1.0 keeps the original timing, larger
+ * values replay faster and 0 replays as fast as possible.
+ * Returns 0 on success, -1 on error (errno is set).
+ */
+int minmea_replay_open(struct minmea_replay *replay, const char *path, double speed);
+
+/**
+ * Unmap the log.
+ */
+void minmea_replay_close(struct minmea_replay *replay);
+
+/**
+ * Select the outputs: a callback, a file descriptor (pty, pipe or connected
+ * UDP socket, written with CRLF line endings), or both. Pass NULL / -1 to
+ * disable either.
+ */
+void minmea_replay_output(struct minmea_replay *replay, minmea_replay_cb callback, void *user, int fd);
+
+/**
+ * Current CLOCK_MONOTONIC time in nanoseconds.
+ */
+int_least64_t minmea_replay_now(void);
+
+/**
+ * Deliver the sentences due at monotonic time now_ns, at most
+ * MINMEA_REPLAY_BURST of them. Returns the deadline of the next sentence (at
+ * or before now_ns if it is already due), or -1 once the log is exhausted. A
+ * single thread can drive many replays by polling each and sleeping until
+ * the earliest deadline.
+ */
+int_least64_t minmea_replay_poll(struct minmea_replay *replay, int_least64_t now_ns);
+
+/**
+ * Replay the whole log, sleeping on an absolute high-resolution timer
+ * between sentences. Returns 0 on success, -1 on error.
+ */
+int minmea_replay_run(struct minmea_replay *replay);
+
+/**
+ * Achieved rate and timing jitter so far.
+ */
+void minmea_replay_stats(const struct minmea_replay *replay, struct minmea_replay_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MINMEA_REPLAY_H */
+
+/* vim: set ts=4 sw=4 et: */
@@ -0,0 +1,297 @@
+/**
+ * @file nmea_shm.c
+ * @brief Shared-memory fan-out of parsed frames to local consumers.
+ * @author wwk (1162431386@qq.com)
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2024  by  xxx
+ *
+ * @par 修改日志:
+ * <table>
+ * <tr><th>Date       <th>Version <th>Author  <th>Description
+ * <tr><td>2026-10-19     <td>1.0     <td>wwk   <td>新建
+ * </table>
+ */
+#include "nmea_shm.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define SHM_MAGIC   0x53514d4du   // "MMQS"
+#define SHM_VERSION 1
+
+struct shm_header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t slot_count;
+    uint32_t slot_size;
+    _Atomic uint32_t generation;
+    _Alignas(64) _Atomic uint64_t head;
+};
+
+// Slots are cache-line aligned so neighbouring writes don't disturb readers.
+struct shm_slot {
+    _Alignas(64) _Atomic uint64_t seq;
+    int32_t id;
+    union minmea_frame frame;
+};
+
+#define SHM_SLOTS_OFFSET ((sizeof(struct shm_header) + 63) & ~(size_t) 63)
+
+static struct shm_slot *shm_slots(const void *base)
+{
+    return (struct shm_slot *) ((char *) base + SHM_SLOTS_OFFSET);
+}
+
+/**
+ * Retire a ring of another size that readers may still have mapped. It is
+ * left intact (shrinking it would fault their reads) but marked with slot
+ * count 0 and a new generation, which makes them reopen. Returns the
+ * generation to continue from.
+ */
+static uint32_t shm_retire(int fd, size_t size)
+{
+    uint32_t generation = 0;
+
+    if (size < sizeof(struct shm_header))
+        return generation;
+
+    void *base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED)
+        return generation;
+
+    struct shm_header *header = base;
+    if (header->magic == SHM_MAGIC) {
+        generation = atomic_load(&header->generation) + 1;
+        header->slot_count = 0;
+        atomic_store_explicit(&header->generation, generation, memory_order_release);
+    }
+    munmap(base, size);
+
+    return generation;
+}
+
+int minmea_shm_publisher_open(struct minmea_shm_publisher *publisher, const char *name, uint32_t slot_count)
+{
+    memset(publisher, 0, sizeof(*publisher));
+    if (slot_count == 0) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    int fd = shm_open(name, O_CREAT | O_RDWR | O_CLOEXEC, 0644);
+    if (fd == -1)
+        return -1;
+
+    size_t size = SHM_SLOTS_OFFSET + (size_t) slot_count * sizeof(struct shm_slot);
+    uint32_t generation = 0;
+    struct stat st;
+    if (fstat(fd, &st) == -1)
+        goto fail;
+
+    if (st.st_size != 0 && (size_t) st.st_size != size) {
+        // Replace the old ring with a new segment under the same name.
+        generation = shm_retire(fd, st.st_size);
+        close(fd);
+        if (shm_unlink(name) == -1 && errno != ENOENT)
+            return -1;
+        fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0644);
+        if (fd == -1)
+            return -1;
+        st.st_size = 0;
+    }
+    if (st.st_size == 0 && ftruncate(fd, size) == -1)
+        goto fail;
+
+    void *base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    int saved = errno;
+    close(fd);
+    if (base == MAP_FAILED) {
+        errno = saved;
+        return -1;
+    }
+
+    struct shm_header *header = base;
+    struct shm_slot *slots = shm_slots(base);
+    // A previous publisher's ring is reused; readers notice the new generation.
+    if (header->magic == SHM_MAGIC)
+        generation = atomic_load(&header->generation) + 1;
+    else if (generation == 0)
+        generation = 1;
+
+    atomic_store(&header->head, 0);
+    for (uint32_t i = 0; i < slot_count; i++)
+        atomic_store_explicit(&slots[i].seq, 0, memory_order_relaxed);
+    header->slot_count = slot_count;
+    header->slot_size = sizeof(struct shm_slot);
+    header->version = SHM_VERSION;
+    atomic_store_explicit(&header->generation, generation, memory_order_release);
+    header->magic = SHM_MAGIC;
+
+    publisher->base = base;
+    publisher->size = size;
+    publisher->slot_count = slot_count;
+    publisher->next = 0;
+    return 0;
+
+fail:
+    saved = errno;
+    close(fd);
+    errno = saved;
+    return -1;
+}
+
+void minmea_shm_publisher_close(struct minmea_shm_publisher *publisher)
+{
+    if (publisher->base)
+        munmap(publisher->base, publisher->size);
+    publisher->base = NULL;
+}
+
+void minmea_shm_publish_frame(struct minmea_shm_publisher *publisher, enum minmea_sentence_id id, const union minmea_frame *frame)
+{
+    struct shm_header *header = publisher->base;
+    uint64_t n = publisher->next;
+    struct shm_slot *slot = &shm_slots(publisher->base)[n % publisher->slot_count];
+
+    // Odd while writing; the release fence keeps the payload stores after it.
+    atomic_store_explicit(&slot->seq, 2 * n + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    slot->id = id;
+    slot->frame = *frame;
+    atomic_store_explicit(&slot->seq, 2 * n + 2, memory_order_release);
+
+    publisher->next = n + 1;
+    atomic_store_explicit(&header->head, n + 1, memory_order_release);
+}
+
+enum minmea_sentence_id minmea_shm_publish(struct minmea_shm_publisher *publisher, const char *sentence, bool strict)
+{
+    union minmea_frame frame;
+    enum minmea_sentence_id id = minmea_parse(&frame, sentence, strict);
+
+    if (id > MINMEA_UNKNOWN)
+        minmea_shm_publish_frame(publisher, id, &frame);
+
+    return id;
+}
+
+int minmea_shm_reader_open(struct minmea_shm_reader *reader, const char *name)
+{
+    memset(reader, 0, sizeof(*reader));
+
+    int fd = shm_open(name, O_RDONLY | O_CLOEXEC, 0);
+    if (fd == -1)
+        return -1;
+
+    struct stat st;
+    if (fstat(fd, &st) == -1) {
+        int saved = errno;
+        close(fd);
+        errno = saved;
+        return -1;
+    }
+    if ((size_t) st.st_size < SHM_SLOTS_OFFSET) {
+        close(fd);
+        errno = EINVAL;
+        return -1;
+    }
+
+    void *base = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    int saved = errno;
+    close(fd);
+    if (base == MAP_FAILED) {
+        errno = saved;
+        return -1;
+    }
+
+    const struct shm_header *header = base;
+    if (header->magic != SHM_MAGIC || header->version != SHM_VERSION ||
+        header->slot_size != sizeof(struct shm_slot) ||
+        SHM_SLOTS_OFFSET + (size_t) header->slot_count * sizeof(struct shm_slot) > (size_t) st.st_size) {
+        munmap(base, st.st_size);
+        errno = EINVAL;
+        return -1;
+    }
+
+    reader->base = base;
+    reader->size = st.st_size;
+    reader->slot_count = header->slot_count;
+    reader->generation = atomic_load_explicit(&((struct shm_header *) base)->generation, memory_order_acquire);
+    reader->next = atomic_load_explicit(&((struct shm_header *) base)->head, memory_order_acquire);
+    return 0;
+}
+
+void minmea_shm_reader_close(struct minmea_shm_reader *reader)
+{
+    if (reader->base)
+        munmap((void *) reader->base, reader->size);
+    reader->base = NULL;
+}
+
+int minmea_shm_read(struct minmea_shm_reader *reader, enum minmea_sentence_id *id, union minmea_frame *frame)
+{
+    struct shm_header *header = (struct shm_header *) reader->base;
+    struct shm_slot *slots = shm_slots(reader->base);
+
+    uint32_t generation = atomic_load_explicit(&header->generation, memory_order_acquire);
+    uint64_t head = atomic_load_explicit(&header->head, memory_order_acquire);
+
+    if (generation != reader->generation) {
+        // The publisher restarted; follow the new ring from its start. A
+        // ring of a different size needs a fresh mapping.
+        if (header->slot_count != reader->slot_count) {
+            errno = ESTALE;
+            return -1;
+        }
+        reader->generation = generation;
+        reader->next = 0;
+        errno = ECONNRESET;
+        return -1;
+    }
+
+    if (reader->next >= head)
+        return 0;
+
+    if (head - reader->next > reader->slot_count) {
+        uint64_t oldest = head - reader->slot_count;
+        reader->lost += oldest - reader->next;
+        reader->next = oldest;
+        errno = EOVERFLOW;
+        return -1;
+    }
+
+    uint64_t n = reader->next;
+    struct shm_slot *slot = &slots[n % reader->slot_count];
+
+    uint64_t before = atomic_load_explicit(&slot->seq, memory_order_acquire);
+    if (before == 2 * n + 2) {
+        int32_t slot_id = slot->id;
+        *frame = slot->frame;
+        atomic_thread_fence(memory_order_acquire);
+        uint64_t after = atomic_load_explicit(&slot->seq, memory_order_relaxed);
+        if (after == before) {
+            *id = slot_id;
+            reader->next = n + 1;
+            return 1;
+        }
+    }
+
+    // Overwritten while we were looking at it.
+    head = atomic_load_explicit(&header->head, memory_order_acquire);
+    uint64_t oldest = head > reader->slot_count ? head - reader->slot_count : 0;
+    if (oldest <= n)
+        oldest = n + 1;
+    reader->lost += oldest - n;
+    reader->next = oldest;
+    errno = EOVERFLOW;
+    return -1;
+}
+
+/* vim: set ts=4 sw=4 et: */
@@ -0,0 +1,102 @@
+/**
+ * @file nmea_shm.h
+ * @brief Shared-memory fan-out of parsed frames to local consumers.
+ * @author wwk (1162431386@qq.com)
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2024  by  xxx
+ *
+ * @par 修改日志:
+ * <table>
+ * <tr><th>Date       <th>Version <th>Author  <th>Description
+ * <tr><td>2026-10-19     <td>1.0     <td>wwk   <td>新建
+ * </table>
+ */
+
+#ifndef MINMEA_SHM_H
+#define MINMEA_SHM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+#include "nmea.h"
+
+/*
+ * A single publisher parses each sentence once and writes the frame into a
+ * POSIX shared-memory ring. Every slot carries a sequence number that is odd
+ * while the slot is being written, so readers map the ring read-only and
+ * follow it without locks or system calls. A reader that falls more than a
+ * ring length behind is moved forward and the skipped frames are counted.
+ */
+
+struct minmea_shm_publisher {
+    void *base;
+    size_t size;
+    uint32_t slot_count;
+    uint64_t next;
+};
+
+struct minmea_shm_reader {
+    const void *base;
+    size_t size;
+    uint32_t slot_count;
+    uint32_t generation;
+    uint64_t next;
+    unsigned long lost;
+};
+
+/**
+ * Create (or take over) the ring with the given shm_open() name and number
+ * of slots. A ring of another size is replaced by a new segment; readers of
+ * the old one get ESTALE. Returns 0 on success, -1 on error (errno is set).
+ */
+int minmea_shm_publisher_open(struct minmea_shm_publisher *publisher, const char *name, uint32_t slot_count);
+
+/**
+ * Unmap the ring. Readers keep their mappings; use shm_unlink() to remove it.
+ */
+void minmea_shm_publisher_close(struct minmea_shm_publisher *publisher);
+
+/**
+ * Parse a sentence and publish the frame. Returns the sentence identifier;
+ * only successfully parsed sentences are published.
+ */
+enum minmea_sentence_id minmea_shm_publish(struct minmea_shm_publisher *publisher, const char *sentence, bool strict);
+
+/**
+ * Publish an already parsed frame.
+ */
+void minmea_shm_publish_frame(struct minmea_shm_publisher *publisher, enum minmea_sentence_id id, const union minmea_frame *frame);
+
+/**
+ * Map an existing ring read-only, positioned at its newest frame.
+ * Returns 0 on success, -1 on error (errno is set).
+ */
+int minmea_shm_reader_open(struct minmea_shm_reader *reader, const char *name);
+
+void minmea_shm_reader_close(struct minmea_shm_reader *reader);
+
+/**
+ * Fetch the next frame. Returns 1 with the frame filled in, 0 if no new
+ * frame has been published, or -1 with errno set to:
+ *
+ * - EOVERFLOW: the reader was lapped. It is moved to the oldest frame still
+ *   in the ring and the number of skipped frames is added to lost.
+ * - ECONNRESET: the publisher restarted. Reading continues from the start
+ *   of the new ring; frames published before the restart are gone.
+ * - ESTALE: the publisher restarted with a different ring size. The reader
+ *   must be reopened.
+ */
+int minmea_shm_read(struct minmea_shm_reader *reader, enum minmea_sentence_id *id, union minmea_frame *frame);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MINMEA_SHM_H */
+
+/* vim: set ts=4 sw=4 et: */
@@ -0,0 +1,199 @@
+/**
+ * @file nmea_stats.c
+ * @brief Sliding-window receiver quality statistics.
+ * @author wwk (1162431386@qq.com)
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2024  by  xxx
+ *
+ * @par 修改日志:
+ * <table>
+ * <tr><th>Date       <th>Version <th>Author  <th>Description
+ * <tr><td>2026-10-19     <td>1.0     <td>wwk   <td>新建
+ * </table>
+ */
+#include "nmea_stats.h"
+
+#include <math.h>
+#include <string.h>
+
+#define W MINMEA_STATS_WINDOW
+
+void minmea_window_init(struct minmea_window *window)
+{
+    memset(window, 0, sizeof(*window));
+}
+
+void minmea_window_push(struct minmea_window *window, float value)
+{
+    uint32_t n = window->samples++;
+    size_t slot = n % W;
+
+    // Drop the sample leaving the window before its slot is reused.
+    if (n >= W) {
+        window->sum -= window->values[slot];
+        if (window->min_length && window->min_queue[window->min_head] == n - W) {
+            window->min_head = (window->min_head + 1) % W;
+            window->min_length--;
+        }
+        if (window->max_length && window->max_queue[window->max_head] == n - W) {
+            window->max_head = (window->max_head + 1) % W;
+            window->max_length--;
+        }
+    }
+
+    // Keep the queues monotonic: nothing older and worse can become the extreme.
+    while (window->min_length &&
+           window->values[window->min_queue[(window->min_head + window->min_length - 1) % W] % W] >= value)
+        window->min_length--;
+    while (window->max_length &&
+           window->values[window->max_queue[(window->max_head + window->max_length - 1) % W] % W] <= value)
+        window->max_length--;
+
+    window->values[slot] = value;
+    window->min_queue[(window->min_head + window->min_length++) % W] = n;
+    window->max_queue[(window->max_head + window->max_length++) % W] = n;
+
+    // Re-sum once per lap so rounding errors cannot build up.
+    if (slot == W - 1) {
+        double sum = 0;
+        for (size_t i = 0; i < W; i++)
+            sum += window->values[i];
+        window->sum = sum;
+    } else {
+        window->sum += value;
+    }
+}
+
+void minmea_window_get(const struct minmea_window *window, struct minmea_window_stats *stats)
+{
+    if (window->samples == 0) {
+        stats->count = 0;
+        stats->mean = stats->min = stats->max = stats->last = NAN;
+        return;
+    }
+
+    stats->count = window->samples < W ? window->samples : W;
+    stats->mean = window->sum / stats->count;
+    stats->min = window->values[window->min_queue[window->min_head] % W];
+    stats->max = window->values[window->max_queue[window->max_head] % W];
+    stats->last = window->values[(window->samples - 1) % W];
+}
+
+static void push_float(struct minmea_window *window, const struct minmea_float *f)
+{
+    float value = minmea_tofloat(f);
+    if (!isnan(value))
+        minmea_window_push(window, value);
+}
+
+void minmea_stats_init(struct minmea_stats *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    stats->semi_major_orientation = NAN;
+}
+
+void minmea_stats_add_gsa(struct minmea_stats *stats, const struct minmea_sentence_gsa *frame)
+{
+    push_float(&stats->pdop, &frame->pdop);
+    push_float(&stats->hdop, &frame->hdop);
+    push_float(&stats->vdop, &frame->vdop);
+}
+
+void minmea_stats_add_gsv(struct minmea_stats *stats, const struct minmea_sentence_gsv *frame)
+{
+    for (int i = 0; i < 4; i++) {
+        const struct minmea_sat_info *sat = &frame->sats[i];
+        // An empty SNR field (not tracking) reads as 0.
+        if (sat->nr == 0 || sat->snr <= 0)
+            continue;
+
+        int bin = sat->snr / MINMEA_STATS_SNR_BIN_WIDTH;
+        if (bin >= MINMEA_STATS_SNR_BINS)
+            bin = MINMEA_STATS_SNR_BINS - 1;
+
+        size_t slot = stats->snr_samples % MINMEA_STATS_SNR_WINDOW;
+        if (stats->snr_samples >= MINMEA_STATS_SNR_WINDOW)
+            stats->snr_histogram[stats->snr_ring[slot]]--;
+        stats->snr_ring[slot] = bin;
+        stats->snr_histogram[bin]++;
+        stats->snr_samples++;
+    }
+}
+
+void minmea_stats_add_gga(struct minmea_stats *stats, const struct minmea_sentence_gga *frame)
+{
+    if (frame->fix_quality < 0 || frame->fix_quality >= MINMEA_STATS_FIX_QUALITIES)
+        return;
+
+    size_t slot = stats->fix_samples % W;
+    if (stats->fix_samples >= W)
+        stats->fix_counts[stats->fix_ring[slot]]--;
+    stats->fix_ring[slot] = frame->fix_quality;
+    stats->fix_counts[frame->fix_quality]++;
+    stats->fix_samples++;
+
+    minmea_window_push(&stats->satellites, frame->satellites_tracked);
+}
+
+void minmea_stats_add_gst(struct minmea_stats *stats, const struct minmea_sentence_gst *frame)
+{
+    push_float(&stats->semi_major, &frame->semi_major_deviation);
+    push_float(&stats->semi_minor, &frame->semi_minor_deviation);
+    push_float(&stats->latitude_error, &frame->latitude_error_deviation);
+    push_float(&stats->longitude_error, &frame->longitude_error_deviation);
+    push_float(&stats->altitude_error, &frame->altitude_error_deviation);
+
+    // Orientation is an axis (0..180 degrees), so only the latest is kept.
+    float orientation = minmea_tofloat(&frame->semi_major_orientation);
+    if (!isnan(orientation))
+        stats->semi_major_orientation = orientation;
+}
+
+/**
+ * Quantile of the SNR histogram, interpolating linearly inside the bin.
+ */
+static float snr_quantile(const uint16_t *histogram, uint32_t count, float q)
+{
+    if (count == 0)
+        return NAN;
+
+    float target = q * count;
+    uint32_t below = 0;
+    for (int i = 0; i < MINMEA_STATS_SNR_BINS; i++) {
+        if (histogram[i] && below + histogram[i] >= target)
+            return (i + (target - below) / histogram[i]) * MINMEA_STATS_SNR_BIN_WIDTH;
+        below += histogram[i];
+    }
+    return MINMEA_STATS_SNR_BINS * MINMEA_STATS_SNR_BIN_WIDTH;
+}
+
+void minmea_stats_snapshot(const struct minmea_stats *stats, struct minmea_stats_snapshot *snapshot)
+{
+    minmea_window_get(&stats->pdop, &snapshot->pdop);
+    minmea_window_get(&stats->hdop, &snapshot->hdop);
+    minmea_window_get(&stats->vdop, &snapshot->vdop);
+    minmea_window_get(&stats->satellites, &snapshot->satellites);
+    minmea_window_get(&stats->semi_major, &snapshot->semi_major);
+    minmea_window_get(&stats->semi_minor, &snapshot->semi_minor);
+    minmea_window_get(&stats->latitude_error, &snapshot->latitude_error);
+    minmea_window_get(&stats->longitude_error, &snapshot->longitude_error);
+    minmea_window_get(&stats->altitude_error, &snapshot->altitude_error);
+    snapshot->semi_major_orientation = stats->semi_major_orientation;
+
+    uint32_t snr_count = stats->snr_samples < MINMEA_STATS_SNR_WINDOW
+                       ? stats->snr_samples : MINMEA_STATS_SNR_WINDOW;
+    snapshot->snr_count = snr_count;
+    snapshot->snr_p10 = snr_quantile(stats->snr_histogram, snr_count, 0.1f);
+    snapshot->snr_p50 = snr_quantile(stats->snr_histogram, snr_count, 0.5f);
+    snapshot->snr_p90 = snr_quantile(stats->snr_histogram, snr_count, 0.9f);
+    memcpy(snapshot->snr_histogram, stats->snr_histogram, sizeof(snapshot->snr_histogram));
+
+    uint32_t fix_count = stats->fix_samples < W ? stats->fix_samples : W;
+    snapshot->fix_count = fix_count;
+    for (int i = 0; i < MINMEA_STATS_FIX_QUALITIES; i++)
+        snapshot->fix_ratio[i] = fix_count ? (float) stats->fix_counts[i] / fix_count : NAN;
+}
+
+/* vim: set ts=4 sw=4 et: */
@@ -0,0 +1,126 @@
+/**
+ * @file nmea_stats.h
+ * @brief Sliding-window receiver quality statistics.
+ * @author wwk (1162431386@qq.com)
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2024  by  xxx
+ *
+ * @par 修改日志:
+ * <table>
+ * <tr><th>Date       <th>Version <th>Author  <th>Description
+ * <tr><td>2026-10-19     <td>1.0     <td>wwk   <td>新建
+ * </table>
+ */
+
+#ifndef MINMEA_STATS_H
+#define MINMEA_STATS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "nmea.h"
+
+// Samples kept per windowed value (epochs for GSA/GGA/GST); a power of two
+// keeps the window consistent when the sample counter wraps.
+#ifndef MINMEA_STATS_WINDOW
+#define MINMEA_STATS_WINDOW 64
+#endif
+
+// SNR samples kept for the histogram (up to four per GSV sentence).
+#ifndef MINMEA_STATS_SNR_WINDOW
+#define MINMEA_STATS_SNR_WINDOW 256
+#endif
+
+// SNR histogram: 5 dB-Hz bins from 0 to 99.
+#define MINMEA_STATS_SNR_BIN_WIDTH 5
+#define MINMEA_STATS_SNR_BINS 20
+
+// GGA fix quality values 0..8.
+#define MINMEA_STATS_FIX_QUALITIES 9
+
+/**
+ * Sliding window over the last MINMEA_STATS_WINDOW samples with O(1)
+ * amortized mean, minimum and maximum (monotonic queues of sample numbers).
+ */
+struct minmea_window {
+    float values[MINMEA_STATS_WINDOW];
+    uint32_t min_queue[MINMEA_STATS_WINDOW];
+    uint32_t max_queue[MINMEA_STATS_WINDOW];
+    uint16_t min_head, min_length;
+    uint16_t max_head, max_length;
+    uint32_t samples;
+    double sum;
+};
+
+struct minmea_window_stats {
+    uint32_t count;
+    float mean;
+    float min;
+    float max;
+    float last;
+};
+
+/**
+ * Per-receiver aggregates, updated directly from parsed frames.
+ */
+struct minmea_stats {
+    struct minmea_window pdop, hdop, vdop;
+    struct minmea_window satellites;
+    struct minmea_window semi_major, semi_minor;
+    struct minmea_window latitude_error, longitude_error, altitude_error;
+    float semi_major_orientation;
+
+    uint8_t snr_ring[MINMEA_STATS_SNR_WINDOW];
+    uint32_t snr_samples;
+    uint16_t snr_histogram[MINMEA_STATS_SNR_BINS];
+
+    uint8_t fix_ring[MINMEA_STATS_WINDOW];
+    uint32_t fix_samples;
+    uint16_t fix_counts[MINMEA_STATS_FIX_QUALITIES];
+};
+
+struct minmea_stats_snapshot {
+    struct minmea_window_stats pdop, hdop, vdop;
+    struct minmea_window_stats satellites;
+    struct minmea_window_stats semi_major, semi_minor;
+    struct minmea_window_stats latitude_error, longitude_error, altitude_error;
+    float semi_major_orientation;
+
+    uint32_t snr_count;
+    float snr_p10, snr_p50, snr_p90;
+    uint16_t snr_histogram[MINMEA_STATS_SNR_BINS];
+
+    uint32_t fix_count;
+    float fix_ratio[MINMEA_STATS_FIX_QUALITIES];
+};
+
+void minmea_window_init(struct minmea_window *window);
+void minmea_window_push(struct minmea_window *window, float value);
+void minmea_window_get(const struct minmea_window *window, struct minmea_window_stats *stats);
+
+void minmea_stats_init(struct minmea_stats *stats);
+
+/**
+ * Feed parsed frames. Unknown ("empty") values are skipped.
+ */
+void minmea_stats_add_gsa(struct minmea_stats *stats, const struct minmea_sentence_gsa *frame);
+void minmea_stats_add_gsv(struct minmea_stats *stats, const struct minmea_sentence_gsv *frame);
+void minmea_stats_add_gga(struct minmea_stats *stats, const struct minmea_sentence_gga *frame);
+void minmea_stats_add_gst(struct minmea_stats *stats, const struct minmea_sentence_gst *frame);
+
+/**
+ * Summarize the current windows. SNR quantiles are interpolated from the
+ * histogram; values are NaN while there is no data.
+ */
+void minmea_stats_snapshot(const struct minmea_stats *stats, struct minmea_stats_snapshot *snapshot);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MINMEA_STATS_H */
+
+/* vim: set ts=4 sw=4 et: */
@@ -0,0 +1,142 @@
+/**
+ * @file async_test.cpp
+ * @brief Coroutine feed test over a pipe and a pty on one executor.
+ * @author wwk (1162431386@qq.com)
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2024  by  xxx
+ *
+ * @par 修改日志:
+ * <table>
+ * <tr><th>Date       <th>Version <th>Author  <th>Description
+ * <tr><td>2026-10-19     <td>1.0     <td>wwk   <td>新建
+ * </table>
+ *
+ * Build and run from the repository root (see bench/ais_bench.c for the
+ * minmea.h wrapper):
+ *
+ *     cc -O2 -I. -I/tmp/minmea-include -c nmea.c -o /tmp/minmea-include/nmea.o
+ *     cc -O2 -I. -c nmea_feed.c -o /tmp/minmea-include/nmea_feed.o
+ *     c++ -std=c++20 -O2 -I. tests/async_test.cpp /tmp/minmea-include/nmea.o \
+ *         /tmp/minmea-include/nmea_feed.o -lm -pthread -o async_test
+ *     ./async_test
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "nmea_async.hpp"
+
+#define CHECK(cond) do { \
+        if (!(cond)) { \
+            std::fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            failures++; \
+        } \
+    } while (0)
+
+static int failures;
+
+static const char *const gga = "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47\r\n";
+static const char *const rmc = "$GPRMC,081836,A,3751.65,S,14507.36,E,000.0,360.0,130998,011.3,E*62\r\n";
+
+static const int rounds = 50;
+
+/**
+ * Write rounds sentences to fd a few bytes at a time, then close it.
+ */
+static void produce(int fd, const char *line)
+{
+    std::string data;
+    for (int i = 0; i < rounds; i++)
+        data += line;
+
+    for (size_t pos = 0; pos < data.size(); pos += 7) {
+        size_t n = std::min<size_t>(7, data.size() - pos);
+        if (write(fd, data.data() + pos, n) != (ssize_t) n)
+            break;
+        usleep(50);
+    }
+    close(fd);
+}
+
+static minmea::task<void> consume(minmea::async_feed &feed, std::vector<enum minmea_sentence_id> &ids)
+{
+    while (auto s = co_await feed.next())
+        ids.push_back(s->id);
+}
+
+int main()
+{
+    int pipe_fds[2];
+    CHECK(pipe(pipe_fds) == 0);
+
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    CHECK(master != -1 && grantpt(master) == 0 && unlockpt(master) == 0);
+    int slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+    CHECK(slave != -1);
+    termios tio;
+    CHECK(tcgetattr(slave, &tio) == 0);
+    cfmakeraw(&tio);
+    CHECK(tcsetattr(slave, TCSANOW, &tio) == 0);
+
+    minmea_long_pool pool;
+    minmea_long_pool_init(&pool);
+    uint32_t all = pool.free_mask;
+
+    std::vector<enum minmea_sentence_id> from_pipe, from_pty;
+    {
+        minmea::executor ex;
+        minmea::async_feed pipe_feed(ex, pipe_fds[0], true, &pool);
+        minmea::async_feed pty_feed(ex, master, true, &pool);
+        ex.spawn(consume(pipe_feed, from_pipe));
+        ex.spawn(consume(pty_feed, from_pty));
+
+        // Both feeds are served while the writers interleave.
+        std::thread pipe_writer(produce, pipe_fds[1], gga);
+        std::thread pty_writer(produce, slave, rmc);
+        ex.run();
+        pipe_writer.join();
+        pty_writer.join();
+    }
+
+    CHECK(from_pipe.size() == rounds);
+    CHECK(from_pty.size() == rounds);
+    for (auto id : from_pipe)
+        CHECK(id == MINMEA_SENTENCE_GGA);
+    for (auto id : from_pty)
+        CHECK(id == MINMEA_SENTENCE_RMC);
+
+    // A feed destroyed in the middle of a long sentence gives its slot back.
+    int fds[2];
+    CHECK(pipe(fds) == 0);
+    std::string partial = "$GPTXT," + std::string(MINMEA_MAX_SENTENCE_LENGTH + 20, 'A');
+    CHECK(write(fds[1], partial.data(), partial.size()) == (ssize_t) partial.size());
+    close(fds[1]);
+    {
+        std::vector<enum minmea_sentence_id> ids;
+        minmea::executor ex;
+        minmea::async_feed feed(ex, fds[0], false, &pool);
+        ex.spawn(consume(feed, ids));
+        ex.run();
+        CHECK(ids.empty());
+        CHECK(pool.free_mask != all);
+    }
+    CHECK(pool.free_mask == all);
+    close(fds[0]);
+    close(master);
+
+    if (failures)
+        return EXIT_FAILURE;
+    std::printf("async_test: ok\n");
+    return EXIT_SUCCESS;
+}
+
+/* vim: set ts=4 sw=4 et: */
@@ -0,0 +1,157 @@
+/**
+ * @file feed_test.c
+ * @brief Non-blocking feed test over a pipe and a pty.
+ * @author wwk (1162431386@qq.com)
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2024  by  xxx
+ *
+ * @par 修改日志:
+ * <table>
+ * <tr><th>Date       <th>Version <th>Author  <th>Description
+ * <tr><td>2026-10-19     <td>1.0     <td>wwk   <td>新建
+ * </table>
+ *
+ * Build and run from the repository root (see bench/ais_bench.c for the
+ * minmea.h wrapper):
+ *
+ *     cc -O2 -I. -I/tmp/minmea-include tests/feed_test.c nmea.c nmea_feed.c -lm -o feed_test
+ *     ./feed_test
+ */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "nmea_feed.h"
+
+#define CHECK(cond) do { \
+        if (!(cond)) { \
+            fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            failures++; \
+        } \
+    } while (0)
+
+static int failures;
+
+static const char *const gga = "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47";
+static const char *const rmc = "$GPRMC,081836,A,3751.65,S,14507.36,E,000.0,360.0,130998,011.3,E*62";
+
+static void put(int fd, const char *data)
+{
+    size_t length = strlen(data);
+    CHECK(write(fd, data, length) == (ssize_t) length);
+}
+
+/**
+ * minmea_feed_next(), waiting a little for input: a pty passes written bytes
+ * on asynchronously.
+ */
+static int next(struct minmea_feed *feed, const char **sentence)
+{
+    int r = minmea_feed_next(feed, sentence);
+    if (r == 0) {
+        struct pollfd pfd = { .fd = feed->fd, .events = POLLIN };
+        poll(&pfd, 1, 1000);
+        r = minmea_feed_next(feed, sentence);
+    }
+    return r;
+}
+
+/**
+ * Sentences split across writes come out whole; end of input is reported
+ * once the writer is gone.
+ */
+static void check_stream(int reader, int writer)
+{
+    struct minmea_feed feed;
+    const char *sentence;
+
+    CHECK(minmea_feed_init(&feed, reader, NULL) == 0);
+    CHECK(fcntl(reader, F_GETFL) & O_NONBLOCK);
+
+    CHECK(minmea_feed_next(&feed, &sentence) == 0);
+
+    put(writer, "noise");
+    put(writer, gga);
+    put(writer, "\r\n$GPRMC,081836,A,3751.65,S,");
+    CHECK(next(&feed, &sentence) == 1 && strcmp(sentence, gga) == 0);
+    CHECK(minmea_feed_next(&feed, &sentence) == 0);
+
+    put(writer, rmc + strlen("$GPRMC,081836,A,3751.65,S,"));
+    put(writer, "\r\n");
+    CHECK(next(&feed, &sentence) == 1 && strcmp(sentence, rmc) == 0);
+    CHECK(minmea_feed_next(&feed, &sentence) == 0);
+
+    close(writer);
+    errno = EBADF;
+    CHECK(next(&feed, &sentence) == -1 && errno == 0);
+
+    minmea_feed_release(&feed);
+    close(reader);
+}
+
+/**
+ * A partial long sentence holds a pool slot until the feed is released.
+ */
+static void check_release(void)
+{
+    struct minmea_long_pool pool;
+    struct minmea_feed feed;
+    const char *sentence;
+    int fds[2];
+
+    minmea_long_pool_init(&pool);
+    uint32_t all = pool.free_mask;
+
+    CHECK(pipe(fds) == 0);
+    CHECK(minmea_feed_init(&feed, fds[0], &pool) == 0);
+
+    char line[MINMEA_MAX_SENTENCE_LENGTH + 40];
+    memset(line, 'A', sizeof(line) - 1);
+    memcpy(line, "$GPTXT,", 7);
+    line[sizeof(line) - 1] = '\0';
+    put(fds[1], line);
+
+    CHECK(minmea_feed_next(&feed, &sentence) == 0);
+    CHECK(pool.free_mask != all);
+    minmea_feed_release(&feed);
+    CHECK(pool.free_mask == all);
+
+    close(fds[0]);
+    close(fds[1]);
+}
+
+int main(void)
+{
+    int fds[2];
+    CHECK(pipe(fds) == 0);
+    check_stream(fds[0], fds[1]);
+
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    CHECK(master != -1 && grantpt(master) == 0 && unlockpt(master) == 0);
+    int slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+    CHECK(slave != -1);
+
+    // Pass bytes through unchanged, as a GNSS serial port would.
+    struct termios tio;
+    CHECK(tcgetattr(slave, &tio) == 0);
+    cfmakeraw(&tio);
+    CHECK(tcsetattr(slave, TCSANOW, &tio) == 0);
+    check_stream(master, slave);
+
+    check_release();
+
+    if (failures)
+        return EXIT_FAILURE;
+    printf("feed_test: ok\n");
+    return EXIT_SUCCESS;
+}
+
+/* vim: set ts=4 sw=4 et: */
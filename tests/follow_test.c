@@ -0,0 +1,136 @@
+/**
+ * @file follow_test.c
+ * @brief Tail-follow test: missing file, appends, rotation and truncation.
+ * @author wwk (1162431386@qq.com)
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2024  by  xxx
+ *
+ * @par 修改日志:
+ * <table>
+ * <tr><th>Date       <th>Version <th>Author  <th>Description
+ * <tr><td>2026-10-19     <td>1.0     <td>wwk   <td>新建
+ * </table>
+ *
+ * Build and run from the repository root (see bench/ais_bench.c for the
+ * minmea.h wrapper):
+ *
+ *     cc -O2 -I. -I/tmp/minmea-include tests/follow_test.c nmea.c nmea_follow.c -lm -o follow_test
+ *     ./follow_test
+ */
+#define _GNU_SOURCE
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "nmea_follow.h"
+
+#define CHECK(cond) do { \
+        if (!(cond)) { \
+            fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            failures++; \
+        } \
+    } while (0)
+
+static int failures;
+
+static const char *const gga = "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47";
+static const char *const rmc = "$GPRMC,081836,A,3751.65,S,14507.36,E,000.0,360.0,130998,011.3,E*62";
+
+static void append(const char *path, const char *data)
+{
+    int fd = open(path, O_WRONLY | O_CREAT | O_APPEND, 0644);
+    CHECK(fd != -1);
+    CHECK(write(fd, data, strlen(data)) == (ssize_t) strlen(data));
+    close(fd);
+}
+
+int main(void)
+{
+    char dir[] = "/tmp/minmea-follow-XXXXXX";
+    CHECK(mkdtemp(dir) != NULL);
+    char path[64], rotated[64];
+    snprintf(path, sizeof(path), "%s/gps.log", dir);
+    snprintf(rotated, sizeof(rotated), "%s/gps.log.1", dir);
+
+    struct minmea_long_pool pool;
+    minmea_long_pool_init(&pool);
+    uint32_t all = pool.free_mask;
+
+    static struct minmea_follow follow;
+    const char *sentence;
+
+    // Open before the file exists; nothing may be read from stale state.
+    memset(&follow, 0x41, sizeof(follow));
+    CHECK(minmea_follow_open(&follow, path, 0, &pool) == 0);
+    CHECK(minmea_follow_offset(&follow) == 0);
+    CHECK(minmea_follow_next(&follow, &sentence) == 0 && sentence == NULL);
+    CHECK(minmea_follow_wait(&follow, 0) == 0);
+
+    // Created, then appended to, with a line completed by a later write.
+    append(path, gga);
+    CHECK(minmea_follow_wait(&follow, 1000) == 1);
+    CHECK(minmea_follow_next(&follow, &sentence) == 0);
+    append(path, "\r\n$GPRMC,081836,A,");
+    CHECK(minmea_follow_next(&follow, &sentence) == 1 && strcmp(sentence, gga) == 0);
+    // Past the CR; the LF is skipped on the next call.
+    CHECK(minmea_follow_offset(&follow) == (off_t) strlen(gga) + 1);
+    CHECK(minmea_follow_next(&follow, &sentence) == 0);
+    append(path, rmc + strlen("$GPRMC,081836,A,"));
+    append(path, "\r\n");
+    CHECK(minmea_follow_next(&follow, &sentence) == 1 && strcmp(sentence, rmc) == 0);
+    off_t end = minmea_follow_offset(&follow);
+    CHECK(end == (off_t) (strlen(gga) + strlen(rmc) + 3));
+
+    // Resuming at a saved offset neither loses nor repeats sentences.
+    append(path, gga);
+    append(path, "\n");
+    minmea_follow_close(&follow);
+    CHECK(minmea_follow_open(&follow, path, end, &pool) == 0);
+    CHECK(minmea_follow_next(&follow, &sentence) == 1 && strcmp(sentence, gga) == 0);
+    CHECK(minmea_follow_next(&follow, &sentence) == 0);
+
+    // Rotation: the old file is drained, then the new one is read from 0.
+    append(path, rmc);
+    append(path, "\n");
+    CHECK(rename(path, rotated) == 0);
+    append(path, gga);
+    append(path, "\n");
+    CHECK(minmea_follow_next(&follow, &sentence) == 1 && strcmp(sentence, rmc) == 0);
+    CHECK(minmea_follow_next(&follow, &sentence) == 1 && strcmp(sentence, gga) == 0);
+    CHECK(follow.rotations == 1);
+
+    // Truncation starts over from the beginning.
+    CHECK(truncate(path, 0) == 0);
+    CHECK(minmea_follow_next(&follow, &sentence) == 0);
+    CHECK(follow.truncations == 1 && minmea_follow_offset(&follow) == 0);
+    append(path, rmc);
+    append(path, "\n");
+    CHECK(minmea_follow_next(&follow, &sentence) == 1 && strcmp(sentence, rmc) == 0);
+
+    // A partial long line holds a pool slot until close.
+    char line[MINMEA_MAX_SENTENCE_LENGTH + 40];
+    memset(line, 'A', sizeof(line) - 1);
+    memcpy(line, "$GPTXT,", 7);
+    line[sizeof(line) - 1] = '\0';
+    append(path, line);
+    while (minmea_follow_next(&follow, &sentence) == 1)
+        ;
+    CHECK(pool.free_mask != all);
+    minmea_follow_close(&follow);
+    CHECK(pool.free_mask == all);
+
+    unlink(path);
+    unlink(rotated);
+    rmdir(dir);
+
+    if (failures)
+        return EXIT_FAILURE;
+    printf("follow_test: ok\n");
+    return EXIT_SUCCESS;
+}
+
+/* vim: set ts=4 sw=4 et: */
@@ -0,0 +1,101 @@
+/**
+ * @file shm_test.c
+ * @brief Publisher/reader test of the shared-memory frame ring.
+ * @author wwk (1162431386@qq.com)
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2024  by  xxx
+ *
+ * @par 修改日志:
+ * <table>
+ * <tr><th>Date       <th>Version <th>Author  <th>Description
+ * <tr><td>2026-10-19     <td>1.0     <td>wwk   <td>新建
+ * </table>
+ *
+ * Build and run from the repository root (see bench/ais_bench.c for the
+ * minmea.h wrapper):
+ *
+ *     cc -O2 -I. -I/tmp/minmea-include tests/shm_test.c nmea.c nmea_shm.c -lm -lrt -o shm_test
+ *     ./shm_test
+ */
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "nmea_shm.h"
+
+#define CHECK(cond) do { \
+        if (!(cond)) { \
+            fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            failures++; \
+        } \
+    } while (0)
+
+static int failures;
+
+static const char *const gga = "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47";
+
+int main(void)
+{
+    char name[64];
+    snprintf(name, sizeof(name), "/minmea-shm-test-%ld", (long) getpid());
+
+    struct minmea_shm_publisher publisher;
+    struct minmea_shm_reader reader;
+    enum minmea_sentence_id id;
+    union minmea_frame frame;
+
+    CHECK(minmea_shm_publisher_open(&publisher, name, 4) == 0);
+    CHECK(minmea_shm_reader_open(&reader, name) == 0);
+
+    // Frames arrive in order.
+    CHECK(minmea_shm_read(&reader, &id, &frame) == 0);
+    CHECK(minmea_shm_publish(&publisher, gga, false) == MINMEA_SENTENCE_GGA);
+    CHECK(minmea_shm_publish(&publisher, "$GPGGA,bad", false) == MINMEA_INVALID);
+    CHECK(minmea_shm_read(&reader, &id, &frame) == 1);
+    CHECK(id == MINMEA_SENTENCE_GGA && frame.gga.satellites_tracked == 8);
+    CHECK(minmea_shm_read(&reader, &id, &frame) == 0);
+
+    // A lapped reader skips to the oldest frame still in the ring.
+    for (int i = 0; i < 10; i++)
+        minmea_shm_publish(&publisher, gga, false);
+    errno = 0;
+    CHECK(minmea_shm_read(&reader, &id, &frame) == -1 && errno == EOVERFLOW);
+    CHECK(reader.lost == 6);
+    int frames = 0;
+    while (minmea_shm_read(&reader, &id, &frame) == 1)
+        frames++;
+    CHECK(frames == 4);
+
+    // A restart with the same size is followed in place.
+    minmea_shm_publisher_close(&publisher);
+    CHECK(minmea_shm_publisher_open(&publisher, name, 4) == 0);
+    minmea_shm_publish(&publisher, gga, false);
+    errno = 0;
+    CHECK(minmea_shm_read(&reader, &id, &frame) == -1 && errno == ECONNRESET);
+    CHECK(minmea_shm_read(&reader, &id, &frame) == 1);
+
+    // A restart with another size leaves the old mapping readable but stale.
+    minmea_shm_publisher_close(&publisher);
+    CHECK(minmea_shm_publisher_open(&publisher, name, 64) == 0);
+    errno = 0;
+    CHECK(minmea_shm_read(&reader, &id, &frame) == -1 && errno == ESTALE);
+    minmea_shm_reader_close(&reader);
+    CHECK(minmea_shm_reader_open(&reader, name) == 0);
+    minmea_shm_publish(&publisher, gga, false);
+    CHECK(minmea_shm_read(&reader, &id, &frame) == 1);
+
+    minmea_shm_reader_close(&reader);
+    minmea_shm_publisher_close(&publisher);
+    shm_unlink(name);
+
+    if (failures)
+        return EXIT_FAILURE;
+    printf("shm_test: ok\n");
+    return EXIT_SUCCESS;
+}
+
+/* vim: set ts=4 sw=4 et: */